@@ -43,6 +43,7 @@
 #include "core/GameConfiguration.h"
 #include "core/Globals.h"
 #include "core/Logging.h"
+#include "logic/BitOperations.h"
 
 namespace po = boost::program_options;
 
@@ -131,6 +132,7 @@ int main(int argn, char **argv) {
         global_seed = vm["seed"].as<int>();
     }
     GLOG(info) << "Game seed: " << global_seed;
+    GLOG(info) << "CPU features: " << BitOperations::getCpuFeatures().toString();
 
     // SDL2/OpenGL for graphics
     const int width = vm["width"].as<int>();
@@ -46,7 +46,7 @@ AIPlayer::AIPlayer(const AIConfiguration& config, const string& name, int seed)
     , m_gameState()
     , m_gameConfig()
     , m_color(PlayerColor::NoPlayer)
-    , m_negamax()
+    , m_negamax(config.searchThreads)
     , m_thread()
     , m_openingBook(seed)
     , m_outOfBook(true)
@@ -121,6 +121,7 @@ future<Turn> AIPlayer::doMakeTurn(GameState state) {
     assert(m_playerState != PLAYING);
 
     m_promisedTurn = promise<Turn>();
+    // The copy keeps the hash history so the search sees earlier repetitions
     m_gameState = state;
 
     changeState(PLAYING);
@@ -196,16 +197,18 @@ void AIPlayer::completePromiseWith(const Turn& turn) {
 
 void AIPlayer::searchForPromisedTurn() {
     boost::optional<Turn> turnWithFarthestHorizon;
+    boost::optional<Score> previousScore;
     size_t iteration = 1;
 
     while (canStayInState(PLAYING)
            && iteration <= m_config.maximumDepth
            && !m_hasWinningMove) {
         
-        auto turn = performSearchIteration(iteration, m_gameState, PLAYING);
-        if (!turn) break;
+        auto result = performSearchIteration(iteration, m_gameState, PLAYING, previousScore);
+        if (!result || !result->turn) break;
 
-        turnWithFarthestHorizon = turn;
+        turnWithFarthestHorizon = result->turn;
+        previousScore = result->score;
         ++iteration;
     }
     
@@ -229,10 +232,17 @@ void AIPlayer::play() {
     changeState(PONDERING);
 }
 
-boost::optional<Turn> AIPlayer::performSearchIteration(size_t depth, GameState& state, States aiState) {
+boost::optional<NegamaxResult> AIPlayer::performSearchIteration(size_t depth,
+                                                                GameState& state,
+                                                                States aiState,
+                                                                boost::optional<Score> expectedScore) {
     LOG(info) << "Starting search of depth " << depth;
     
     future<NegamaxResult> result = async(launch::async, [&]{
+        if (expectedScore) {
+            // Narrow the search to the surroundings of the previous result
+            return m_negamax.search(state, depth, *expectedScore);
+        }
         return m_negamax.search(state, depth);
     });
 
@@ -245,7 +255,7 @@ boost::optional<Turn> AIPlayer::performSearchIteration(size_t depth, GameState&
                 
                 m_hasWinningMove = true;
             }
-            return negamaxResult.turn;
+            return negamaxResult;
         }
     }
     LOG(debug) << "Aborting search";
@@ -278,13 +288,17 @@ void AIPlayer::ponder() {
 }
 
 void AIPlayer::performIterativeDeepening() {
+    boost::optional<Score> previousScore;
     size_t iteration = 1;
     while (canStayInState(PONDERING)
         && iteration <= m_config.maximumDepth
-        && !m_hasWinningMove
-        && performSearchIteration(iteration, m_ponderGameState, PONDERING)) {
+        && !m_hasWinningMove) {
+
+        auto result = performSearchIteration(iteration, m_ponderGameState, PONDERING, previousScore);
+        if (!result || !result->turn) break;
 
         LOG(info) << "Pondered " << iteration << " plies deep";
+        previousScore = result->score;
         ++iteration;
     }
 }
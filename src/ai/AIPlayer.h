@@ -123,9 +123,14 @@ private:
      * @param depth Depth to search to.
      * @param state State to search from.
      * @param aiState Current ai state for abortion checks
-     * @return Turn if depth was reached. None otherwise.
+     * @param expectedScore Score of the previous iteration. If given the
+     *        search starts with an aspiration window around it.
+     * @return Search result if depth was reached. None otherwise.
      */
-    boost::optional<Turn> performSearchIteration(size_t depth, GameState& state, States aiState);
+    boost::optional<NegamaxResult> performSearchIteration(size_t depth,
+                                                          GameState& state,
+                                                          States aiState,
+                                                          boost::optional<Score> expectedScore);
 
     //! Returns false if a time limit expired or the current state must be left.
     bool canStayInState(States currentState);
@@ -0,0 +1,242 @@
+/*
+    Copyright (c) 2013-2014, Stefan Hacker <dd0t@users.sourceforge.net>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "ai/MovePicker.h"
+
+namespace {
+
+//! Rough piece values used for ordering captures. Indexed by PieceType.
+const std::array<int, NUM_PIECETYPES> ORDER_VALUES = {{
+    20, // King
+    9,  // Queen
+    3,  // Bishop
+    3,  // Knight
+    5,  // Rook
+    1   // Pawn
+}};
+
+} // namespace
+
+const MoveList& legalMoves(const GameState& state) {
+    return state.getMoveList();
+}
+
+Turn toTurn(const GameState& state, Move move) {
+    return move.toTurn(state.peekChessBoard());
+}
+
+int captureOrderScore(const GameState& state, Move move) {
+    const ChessBoard& board = state.peekChessBoard();
+    const Turn turn = move.toTurn(board);
+
+    int score = NOT_A_CAPTURE;
+    if (turn.piece.type == NoType) {
+        // No piece to move, can't capture anything
+        return score;
+    }
+
+    const Piece victim = board.getPieceAt(turn.to);
+    if (victim.type != NoType) {
+        score = ORDER_VALUES[victim.type] * 32 - ORDER_VALUES[turn.piece.type];
+    } else if (turn.piece.type == Pawn && turn.to == board.getEnPassantSquare()) {
+        score = ORDER_VALUES[Pawn] * 32 - ORDER_VALUES[Pawn];
+    }
+
+    if (turn.action == Turn::PromotionQueen) {
+        score = std::max(score, 0) + ORDER_VALUES[Queen] * 32;
+    }
+
+    return score;
+}
+
+void generateCaptures(const GameState& state, MoveList& capturesOut) {
+    state.generateCaptures(capturesOut);
+}
+
+Score captureGain(const GameState& state, Move move) {
+    const ChessBoard& board = state.peekChessBoard();
+    const Turn turn = move.toTurn(board);
+
+    Score gain = 0;
+
+    const Piece victim = board.getPieceAt(turn.to);
+    if (victim.type != NoType) {
+        gain = IncrementalMaterialAndPSTEvaluator::getPieceValue(victim.type);
+    } else if (turn.piece.type == Pawn && turn.to == board.getEnPassantSquare()) {
+        gain = IncrementalMaterialAndPSTEvaluator::getPieceValue(Pawn);
+    }
+
+    if (turn.isPromotion()) {
+        gain += IncrementalMaterialAndPSTEvaluator::getPieceValue(turn.getPromotionPieceType())
+              - IncrementalMaterialAndPSTEvaluator::getPieceValue(Pawn);
+    }
+
+    return gain;
+}
+
+bool seeGE(const GameState& state, Move move, Score threshold) {
+    const ChessBoard& board = state.peekChessBoard();
+    return board.seeGE(move.toTurn(board), threshold);
+}
+
+bool isInCheck(const GameState& state) {
+    return state.isInCheck();
+}
+
+bool isDrawByRule(const GameState& state) {
+    return state.isDrawDueTo50MovesRule() || state.isDrawDueToInsufficientMaterial();
+}
+
+Score evaluate(const GameState& state, size_t) {
+    return state.getEvaluation();
+}
+
+bool hasNonPawnMaterial(const GameState& state) {
+    return state.peekChessBoard().hasNonPawnMaterial(state.getNextPlayer());
+}
+
+bool findLegalTurn(const GameState& state, Move move, Turn& turnOut) {
+    if (!state.isLegalMove(move)) return false;
+    turnOut = move.toTurn(state.peekChessBoard());
+    return true;
+}
+
+MovePicker<GameState, MoveList>::MovePicker(const GameState& state,
+                                            Move ttMove,
+                                            const Killers& killers,
+                                            bool ordering,
+                                            bool capturesOnly)
+    : m_state(state)
+    , m_ttMove(capturesOnly ? Move() : ttMove)
+    , m_killers(killers)
+    , m_capturesOnly(capturesOnly)
+    , m_stage(ordering ? TT_TURN : UNORDERED)
+    , m_index(0) {
+    if (!ordering) {
+        state.generateCaptures(m_moves);
+        if (!capturesOnly) {
+            state.generateQuiets(m_moves);
+        }
+    }
+}
+
+const Move* MovePicker<GameState, MoveList>::next() {
+    switch (m_stage) {
+    case TT_TURN:
+        m_stage = INIT_CAPTURES;
+        if (!m_ttMove.isNull()) {
+            if (m_state.isLegalMove(m_ttMove)) {
+                return &m_ttMove;
+            }
+            m_ttMove = Move();
+        }
+        // Fall through
+    case INIT_CAPTURES:
+        initCaptures();
+        m_stage = CAPTURES;
+        // Fall through
+    case CAPTURES:
+        while (m_index < m_moves.size()) {
+            const Move* move = pickBestCapture();
+            if (*move != m_ttMove) {
+                return move;
+            }
+        }
+        if (m_capturesOnly) {
+            m_stage = DONE;
+            return nullptr;
+        }
+        m_stage = KILLERS;
+        m_index = 0;
+        // Fall through
+    case KILLERS:
+        while (m_index < m_killers.size()) {
+            Move& killer = m_killers[m_index++];
+            // Captures were handed out already, only quiet killers are tried.
+            // Killers come from siblings, so legality is checked first.
+            if (!killer.isNull() && killer != m_ttMove
+                    && m_state.isLegalMove(killer)
+                    && captureOrderScore(m_state, killer) == NOT_A_CAPTURE) {
+                return &killer;
+            }
+            // Must not hide the turn among the quiets
+            killer = Move();
+        }
+        // Fall through
+    case INIT_QUIETS:
+        m_moves.clear();
+        m_state.generateQuiets(m_moves);
+        m_index = 0;
+        m_stage = QUIETS;
+        // Fall through
+    case QUIETS:
+        while (m_index < m_moves.size()) {
+            const Move* move = &m_moves[m_index++];
+            if (!isPicked(*move)) {
+                return move;
+            }
+        }
+        m_stage = DONE;
+        return nullptr;
+    case UNORDERED:
+        if (m_index < m_moves.size()) {
+            return &m_moves[m_index++];
+        }
+        m_stage = DONE;
+        return nullptr;
+    case DONE:
+    default:
+        return nullptr;
+    }
+}
+
+void MovePicker<GameState, MoveList>::initCaptures() {
+    m_state.generateCaptures(m_moves);
+    for (size_t i = 0; i < m_moves.size(); ++i) {
+        m_captureScores[i] = captureOrderScore(m_state, m_moves[i]);
+    }
+    m_index = 0;
+}
+
+const Move* MovePicker<GameState, MoveList>::pickBestCapture() {
+    size_t best = m_index;
+    for (size_t i = m_index + 1; i < m_moves.size(); ++i) {
+        if (m_captureScores[i] > m_captureScores[best]) best = i;
+    }
+    std::swap(m_moves[best], m_moves[m_index]);
+    std::swap(m_captureScores[best], m_captureScores[m_index]);
+
+    return &m_moves[m_index++];
+}
+
+bool MovePicker<GameState, MoveList>::isPicked(Move move) const {
+    return move == m_ttMove || move == m_killers[0] || move == m_killers[1];
+}
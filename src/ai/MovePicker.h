@@ -0,0 +1,406 @@
+/*
+    Copyright (c) 2013-2014, Stefan Hacker <dd0t@users.sourceforge.net>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef MOVEPICKER_H
+#define MOVEPICKER_H
+
+#include <array>
+#include <bitset>
+#include <cassert>
+
+#include "logic/GameState.h"
+#include "logic/Move.h"
+#include "logic/MoveList.h"
+
+//! Returned by captureOrderScore for turns which are neither capture nor queen promotion.
+const int NOT_A_CAPTURE = -1;
+
+//! Returns the legal turns of state as packed moves.
+const MoveList& legalMoves(const GameState& state);
+
+/**
+ * @brief Fallback for game states without a board (e.g. test mocks).
+ * Their turn list is used as is.
+ */
+template <typename TGameState>
+auto legalMoves(const TGameState& state) -> decltype(state.getTurnList()) {
+    return state.getTurnList();
+}
+
+//! Unpacks a move of state's legal moves.
+Turn toTurn(const GameState& state, Move move);
+
+//! Fallback for game states without a board. Their turns need no unpacking.
+template <typename TGameState>
+Turn toTurn(const TGameState&, const Turn& turn) {
+    return turn;
+}
+
+/**
+ * @brief Returns the MVV-LVA (most valuable victim, least valuable attacker)
+ * ordering score of a capture or queen promotion. NOT_A_CAPTURE otherwise.
+ */
+int captureOrderScore(const GameState& state, Move move);
+
+/**
+ * @brief Fallback for game states without a board.
+ * Every turn is considered quiet.
+ */
+template <typename TGameState, typename TTurn>
+int captureOrderScore(const TGameState&, const TTurn&) {
+    return NOT_A_CAPTURE;
+}
+
+//! Appends the captures and queen promotions of state to capturesOut.
+void generateCaptures(const GameState& state, MoveList& capturesOut);
+
+//! Fallback for game states without a board. There are no captures.
+template <typename TGameState, typename TTurnList>
+void generateCaptures(const TGameState&, TTurnList&) {}
+
+/**
+ * @brief Returns the material a capture or promotion gains at most, that is
+ * if the capturing piece isn't taken back.
+ */
+Score captureGain(const GameState& state, Move move);
+
+//! Fallback for game states without a board.
+template <typename TGameState, typename TTurn>
+Score captureGain(const TGameState&, const TTurn&) {
+    return 0;
+}
+
+//! Returns true if the static exchange evaluation of move is at least threshold.
+bool seeGE(const GameState& state, Move move, Score threshold);
+
+//! Fallback for game states without a board. Every exchange is even.
+template <typename TGameState, typename TTurn>
+bool seeGE(const TGameState&, const TTurn&, Score threshold) {
+    return threshold <= 0;
+}
+
+//! Returns true if the player to move is in check.
+bool isInCheck(const GameState& state);
+
+//! Fallback for game states without a board. Never in check.
+template <typename TGameState>
+bool isInCheck(const TGameState&) {
+    return false;
+}
+
+/**
+ * @brief Returns true if the position is drawn by the 50 moves rule or
+ * insufficient material. Doesn't look for legal turns.
+ */
+bool isDrawByRule(const GameState& state);
+
+//! Fallback for game states without a board. Their getScore covers draws.
+template <typename TGameState>
+bool isDrawByRule(const TGameState&) {
+    return false;
+}
+
+/**
+ * @brief Returns the static evaluation of state from the player to move's
+ * point of view. Doesn't detect checkmate or stalemate.
+ */
+Score evaluate(const GameState& state, size_t depth);
+
+//! Fallback for game states without a board. Uses their score as is.
+template <typename TGameState>
+Score evaluate(const TGameState& state, size_t depth) {
+    return state.getScore(depth);
+}
+
+/**
+ * @brief Returns true if the player to move has pieces besides king and
+ * pawns. Positions without are prone to zugzwang.
+ */
+bool hasNonPawnMaterial(const GameState& state);
+
+//! Fallback for game states without a board. Assumes zugzwang is possible.
+template <typename TGameState>
+bool hasNonPawnMaterial(const TGameState&) {
+    return false;
+}
+
+/**
+ * @brief Returns true if move is a legal turn in state and stores the
+ * unpacked turn in turnOut.
+ */
+bool findLegalTurn(const GameState& state, Move move, Turn& turnOut);
+
+//! Fallback for game states without a board. Searches their turn list.
+template <typename TGameState>
+bool findLegalTurn(const TGameState& state, Move move, Turn& turnOut) {
+    const auto turns = legalMoves(state);
+    const auto* turn = findTurn(turns, move);
+    if (!turn) return false;
+    turnOut = *turn;
+    return true;
+}
+
+/**
+ * @brief Turn selection for the search.
+ * Hands out the turns of a position one by one in the order: transposition
+ * table turn, captures by MVV-LVA, killer turns, remaining quiet turns.
+ *
+ * This is the fallback for game states without a board (e.g. test mocks).
+ * It takes the full turn list of the state up front. GameState has a
+ * specialization which generates the turns stage by stage.
+ * @tparam TGameState Type of game state.
+ * @tparam TTurnList Type of turn list of the game state.
+ */
+template <typename TGameState, typename TTurnList>
+class MovePicker {
+public:
+    //! Killer turns kept per ply.
+    using Killers = std::array<Move, 2>;
+    //! Turn type handed out.
+    using TurnType = typename TTurnList::value_type;
+
+    /**
+     * @brief Creates a picker for the turns of state.
+     * @param state State to pick turns for. Must outlive the picker.
+     * @param ttMove Best turn from the transposition table. Null if none.
+     * @param killers Quiet turns which caused cutoffs in sibling positions.
+     * @param ordering If false turns are handed out in generation order.
+     * @param capturesOnly If true only captures and queen promotions are handed out.
+     */
+    MovePicker(const TGameState& state,
+               Move ttMove,
+               const Killers& killers,
+               bool ordering = true,
+               bool capturesOnly = false)
+        : m_state(state)
+        , m_ttMove(ttMove)
+        , m_killers(killers)
+        , m_stage(ordering ? TT_TURN : UNORDERED)
+        , m_index(0)
+        , m_numCaptures(0) {
+        if (capturesOnly) {
+            generateCaptures(state, m_turns);
+        } else {
+            m_turns = legalMoves(state);
+        }
+        assert(m_turns.size() <= MoveList::CAPACITY);
+    }
+
+    /**
+     * @brief Returns the next turn to search.
+     * @return Pointer to the turn, valid as long as the picker.
+     *         nullptr if all turns were picked.
+     */
+    const TurnType* next() {
+        switch (m_stage) {
+        case TT_TURN:
+            m_stage = INIT_CAPTURES;
+            if (!m_ttMove.isNull()) {
+                const TurnType* turn = findTurn(m_turns, m_ttMove);
+                if (turn) {
+                    markPicked(turn);
+                    return turn;
+                }
+            }
+            // Fall through
+        case INIT_CAPTURES:
+            initCaptures();
+            m_stage = CAPTURES;
+            // Fall through
+        case CAPTURES:
+            if (m_index < m_numCaptures) {
+                return pickBestCapture();
+            }
+            m_stage = KILLERS;
+            m_index = 0;
+            // Fall through
+        case KILLERS:
+            while (m_index < m_killers.size()) {
+                const Move killer = m_killers[m_index++];
+                if (killer.isNull()) continue;
+
+                const TurnType* turn = findTurn(m_turns, killer);
+                if (turn && !isPicked(turn)) {
+                    markPicked(turn);
+                    return turn;
+                }
+            }
+            m_stage = QUIETS;
+            m_index = 0;
+            // Fall through
+        case QUIETS:
+            while (m_index < m_turns.size()) {
+                const TurnType* turn = &m_turns[m_index++];
+                if (!isPicked(turn)) {
+                    return turn;
+                }
+            }
+            m_stage = DONE;
+            return nullptr;
+        case UNORDERED:
+            if (m_index < m_turns.size()) {
+                return &m_turns[m_index++];
+            }
+            m_stage = DONE;
+            return nullptr;
+        case DONE:
+        default:
+            return nullptr;
+        }
+    }
+
+private:
+    enum Stage {
+        TT_TURN,
+        INIT_CAPTURES,
+        CAPTURES,
+        KILLERS,
+        QUIETS,
+        UNORDERED,
+        DONE
+    };
+
+    //! Collects and scores the captures among the not yet picked turns.
+    void initCaptures() {
+        for (size_t i = 0; i < m_turns.size(); ++i) {
+            if (m_picked[i]) continue;
+
+            const int score = captureOrderScore(m_state, m_turns[i]);
+            if (score != NOT_A_CAPTURE) {
+                m_captures[m_numCaptures] = static_cast<uint8_t>(i);
+                m_captureScores[m_numCaptures] = score;
+                ++m_numCaptures;
+                // Captures never show up among killers or quiets
+                m_picked[i] = true;
+            }
+        }
+        m_index = 0;
+    }
+
+    //! Selection sort step. Only sorts as far as turns are actually picked.
+    const TurnType* pickBestCapture() {
+        size_t best = m_index;
+        for (size_t i = m_index + 1; i < m_numCaptures; ++i) {
+            if (m_captureScores[i] > m_captureScores[best]) best = i;
+        }
+        std::swap(m_captures[best], m_captures[m_index]);
+        std::swap(m_captureScores[best], m_captureScores[m_index]);
+
+        return &m_turns[m_captures[m_index++]];
+    }
+
+    size_t indexOf(const TurnType* turn) const {
+        return static_cast<size_t>(turn - &m_turns[0]);
+    }
+
+    void markPicked(const TurnType* turn) { m_picked[indexOf(turn)] = true; }
+    bool isPicked(const TurnType* turn) const { return m_picked[indexOf(turn)]; }
+
+    const TGameState& m_state;
+    TTurnList m_turns;
+    const Move m_ttMove;
+    const Killers m_killers;
+
+    Stage m_stage;
+    //! Position inside the current stage.
+    size_t m_index;
+
+    //! Turns already handed out (or queued as capture).
+    std::bitset<MoveList::CAPACITY> m_picked;
+
+    //! Indices of captures in turn list and their ordering scores.
+    std::array<uint8_t, MoveList::CAPACITY> m_captures;
+    std::array<int, MoveList::CAPACITY> m_captureScores;
+    size_t m_numCaptures;
+};
+
+/**
+ * @brief Staged turn selection for GameState.
+ * Hands out the turns in the same order as the fallback but only generates
+ * what the current stage needs. The transposition table turn and the
+ * killers are checked for legality on the board, captures and quiet turns
+ * are generated once their stage is reached. A beta cutoff on an early
+ * turn skips the generation of the remaining stages.
+ */
+template <>
+class MovePicker<GameState, MoveList> {
+public:
+    //! Killer turns kept per ply.
+    using Killers = std::array<Move, 2>;
+    //! Turn type handed out.
+    using TurnType = Move;
+
+    //! @see MovePicker::MovePicker
+    MovePicker(const GameState& state,
+               Move ttMove,
+               const Killers& killers,
+               bool ordering = true,
+               bool capturesOnly = false);
+
+    //! @see MovePicker::next
+    const Move* next();
+
+private:
+    enum Stage {
+        TT_TURN,
+        INIT_CAPTURES,
+        CAPTURES,
+        KILLERS,
+        INIT_QUIETS,
+        QUIETS,
+        UNORDERED,
+        DONE
+    };
+
+    //! Generates and scores the captures.
+    void initCaptures();
+    //! Selection sort step. Only sorts as far as turns are actually picked.
+    const Move* pickBestCapture();
+    //! Returns true if move was handed out as transposition table turn or killer.
+    bool isPicked(Move move) const;
+
+    const GameState& m_state;
+    //! Null once found illegal.
+    Move m_ttMove;
+    //! Entries not handed out are nulled.
+    Killers m_killers;
+    const bool m_capturesOnly;
+
+    Stage m_stage;
+    //! Position inside the current stage.
+    size_t m_index;
+
+    //! Turns of the current stage and the ordering scores of captures.
+    MoveList m_moves;
+    std::array<int, MoveList::CAPACITY> m_captureScores;
+};
+
+#endif // MOVEPICKER_H
@@ -38,9 +38,16 @@
 #include <array>
 #include <chrono>
 #include <atomic>
+#include <thread>
+#include <vector>
+#include <limits>
+#include <functional>
+#include <type_traits>
+#include <utility>
 
 #include "misc/helper.h"
 #include "ai/TranspositionTable.h"
+#include "ai/MovePicker.h"
 #include "logic/GameState.h"
 #include "core/Logging.h"
 
@@ -81,23 +88,38 @@ struct NegamaxResult {
 
 /**
  * @brief Implementation of a Negamax algorithm.
+ * Can search with multiple threads using Lazy SMP: Helper threads search the
+ * same root position and only share results through the transposition table.
  * @tparam TGameState Type of game state so GameState is mockable.
  * @tparam AB_CUTOFF_ENABLE If false Alpha-Beta cutoff feature is disabled.
  * @tparam MOVE_ORDERING_ENABLED If false move ordering is disabled.
  * @tparam TRANSPOSITION_TABLES_ENABLED If false transposition tables are disabled.
+ * @tparam PRINCIPAL_VARIATION_SEARCH_ENABLED If false principal variation
+ *         search is disabled. Requires Alpha-Beta cutoff.
+ * @tparam QUIESCENCE_SEARCH_ENABLED If false positions at the horizon are
+ *         evaluated statically even in the middle of an exchange.
+ * @tparam NULL_MOVE_PRUNING_ENABLED If false null move pruning is disabled.
+ *         Requires Alpha-Beta cutoff.
  */
 template<typename TGameState = GameState,
          bool AB_CUTOFF_ENABLED = true,
          bool MOVE_ORDERING_ENABLED = true,
-         bool TRANSPOSITION_TABLES_ENABLED = true>
+         bool TRANSPOSITION_TABLES_ENABLED = true,
+         bool PRINCIPAL_VARIATION_SEARCH_ENABLED = true,
+         bool QUIESCENCE_SEARCH_ENABLED = true,
+         bool NULL_MOVE_PRUNING_ENABLED = true>
 class Negamax {
 public:
     /**
      * @brief Creates a new algorithm instance.
+     * @param threads Number of threads to search with. One searches
+     *        without helper threads.
      */
-    Negamax()
+    Negamax(size_t threads = 1)
         : m_transpositionTable()
+        , m_threads(std::max<size_t>(threads, 1))
         , m_abort(false)
+        , m_stopHelpers(false)
         , m_log(Logging::initLogger("Negamax")) {
         // Empty
     }
@@ -110,28 +132,75 @@ public:
      */
     NegamaxResult search(const TGameState& state, size_t maxDepth) {
         m_abort = false;
+        m_counters = PerfCounters();
 
-        LOG(Logging::info) << "Starting " << maxDepth
-                           << " plies deep search. AB-pruning=" << AB_CUTOFF_ENABLED
-                           << " Move ordering=" << MOVE_ORDERING_ENABLED
-                           << " Transposition tables=" << TRANSPOSITION_TABLES_ENABLED;
-        
         auto start = std::chrono::steady_clock::now();
+        logSearchStart(maxDepth);
+
+        TGameState rootState(state);
+        SearchContext context(false);
+        startHelpers(rootState, maxDepth, context);
+
+        NegamaxResult result = searchWindow(rootState, context, maxDepth, MIN_SCORE, MAX_SCORE);
+
+        stopHelpers(context);
+        return finishSearch(result, start);
+    }
 
+    /**
+     * @brief Search given state up to maxDepth plies with an aspiration window.
+     * The search starts with a narrow window around the expected score. If
+     * the result falls outside of it the window is widened on that side and
+     * the search is repeated until the score is exact.
+     * @param state Game state to search.
+     * @param maxDepth Number of plies to search.
+     * @param guess Expected score (e.g. from the previous, shallower search).
+     * @return Result of the search.
+     */
+    NegamaxResult search(const TGameState& state, size_t maxDepth, Score guess) {
+        m_abort = false;
         m_counters = PerfCounters();
-        
-        NegamaxResult result = search_recurse(state, 0, maxDepth, MIN_SCORE, MAX_SCORE);
 
-        m_counters.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::steady_clock::now() - start);
+        auto start = std::chrono::steady_clock::now();
+        logSearchStart(maxDepth);
+
+        // The helpers keep running through all windows
+        TGameState rootState(state);
+        SearchContext context(false);
+        startHelpers(rootState, maxDepth, context);
+
+        Score lowerDelta = ASPIRATION_WINDOW;
+        Score upperDelta = ASPIRATION_WINDOW;
+        if (!AB_CUTOFF_ENABLED || guess > WIN_SCORE_THRESHOLD || guess < -WIN_SCORE_THRESHOLD) {
+            // Without cutoffs windows gain nothing. Mate scores change with
+            // depth so a window around them would fail anyways.
+            lowerDelta = upperDelta = ASPIRATION_WINDOW_LIMIT + 1;
+        }
 
-        if (m_abort) {
-            LOG(Logging::debug) << "Aborted without result";
-        } else {
-            LOG(Logging::debug) << result;
+        NegamaxResult result;
+
+        while (true) {
+            const Score alpha = lowerDelta > ASPIRATION_WINDOW_LIMIT ? MIN_SCORE : guess - lowerDelta;
+            const Score beta = upperDelta > ASPIRATION_WINDOW_LIMIT ? MAX_SCORE : guess + upperDelta;
+
+            result = searchWindow(rootState, context, maxDepth, alpha, beta);
+            if (m_abort) break;
+
+            if (result.score <= alpha && alpha != MIN_SCORE) {
+                lowerDelta *= ASPIRATION_WINDOW_GROWTH;
+            } else if (result.score >= beta && beta != MAX_SCORE) {
+                upperDelta *= ASPIRATION_WINDOW_GROWTH;
+            } else {
+                break;
+            }
+
+            ++m_counters.aspirationResearches;
+            LOG(Logging::debug) << "Aspiration window (" << alpha << ", " << beta
+                                << ") failed with " << result.score;
         }
-        LOG(Logging::debug) << m_counters;
-        return result;
+
+        stopHelpers(context);
+        return finishSearch(result, start);
     }
 
     /**
@@ -142,11 +211,19 @@ public:
         m_abort = true;
     }
 
+    //! Returns the number of threads searching.
+    size_t getThreads() const {
+        return m_threads;
+    }
+
     //! Structure with performance counters used for debugging and evaluation.
     struct PerfCounters {
         PerfCounters()
             : nodes(0), cutoffs(0), updates(0)
-            , transpositionTableHits(0), duration() {}
+            , transpositionTableHits(0)
+            , nullWindowSearches(0), researches(0)
+            , aspirationResearches(0), quiescenceNodes(0)
+            , nullMoves(0), nullMoveCutoffs(0), duration() {}
         
         //! Number of nodes searched.
         uint64_t nodes;
@@ -156,9 +233,36 @@ public:
         uint64_t updates;
         //! Number of transposition table hits during search.
         uint64_t transpositionTableHits;
+        //! Number of turns searched with a null window (PVS).
+        uint64_t nullWindowSearches;
+        //! Number of null window searches which failed high and were repeated.
+        uint64_t researches;
+        //! Number of root searches repeated because of a failed aspiration window.
+        uint64_t aspirationResearches;
+        //! Number of nodes searched beyond the horizon by quiescence search.
+        uint64_t quiescenceNodes;
+        //! Number of null moves searched.
+        uint64_t nullMoves;
+        //! Number of positions pruned because passing already failed high.
+        uint64_t nullMoveCutoffs;
         //! Time taken for last search
         std::chrono::milliseconds duration;
 
+        //! Adds the counts of other. Duration is left untouched.
+        PerfCounters& operator+=(const PerfCounters& other) {
+            nodes += other.nodes;
+            cutoffs += other.cutoffs;
+            updates += other.updates;
+            transpositionTableHits += other.transpositionTableHits;
+            nullWindowSearches += other.nullWindowSearches;
+            researches += other.researches;
+            aspirationResearches += other.aspirationResearches;
+            quiescenceNodes += other.quiescenceNodes;
+            nullMoves += other.nullMoves;
+            nullMoveCutoffs += other.nullMoveCutoffs;
+            return *this;
+        }
+
         std::string toString() const {
             std::stringstream ss;
             const auto ms = duration.count() + 1;
@@ -167,67 +271,211 @@ public:
                << "Nodes visited:   " << nodes << " (~" << nodes / ms << " nodes/ms)" << std::endl
                << "No. of cut offs: " << cutoffs << std::endl
                << "Result updates:  " << updates << std::endl
-               << "Tr. Tbl. Hits:   " << transpositionTableHits << std::endl;
+               << "Tr. Tbl. Hits:   " << transpositionTableHits << std::endl
+               << "Null windows:    " << nullWindowSearches
+               << " (" << researches << " re-searched)" << std::endl
+               << "Aspiration fails:" << aspirationResearches << std::endl
+               << "Quiesc. nodes:   " << quiescenceNodes << std::endl
+               << "Null moves:      " << nullMoves
+               << " (" << nullMoveCutoffs << " cut off)" << std::endl;
             
             return ss.str();
         }
     } m_counters;
     
 private:
+    //! PVS relies on cutoffs to gain anything from its null windows.
+    static const bool PVS_ENABLED = AB_CUTOFF_ENABLED && PRINCIPAL_VARIATION_SEARCH_ENABLED;
+    //! Null move pruning relies on the null window failing high.
+    static const bool NULL_MOVE_ENABLED = AB_CUTOFF_ENABLED && NULL_MOVE_PRUNING_ENABLED;
+
+    //! Plies left above which the null move search is reduced by one ply more.
+    static const size_t NULL_MOVE_DEEP_REDUCTION_DEPTH = 6;
     /**
-     * @brief Helper class for holding a move option in move ordering.
+     * @brief Plies left from which a null move cutoff is verified with a
+     * reduced search of the position itself. Catches zugzwang positions
+     * the material guard misses where it is most expensive to be wrong.
      */
-    class Option {
-    public:
-        /**
-         * @brief Create options for move ordering
-         * @param state State _after_ turn has been applied
-         * @param turn Turn leading to this option.
-         * @param score Score estimation for this option.
-         */
-        Option(TGameState& state, Turn& turn, Score score)
-            : state(&state)
-            , turn(&turn)
-            , score(score) {}
-        
-        TGameState* state;
-        Turn* turn;
-        
-        //! Odering operator which makes sort output descending by score.
-        bool operator<(const Option& other) const { return score > other.score; }
-    private:
-        //! Score estimation for this option
-        Score score;
+    static const size_t NULL_MOVE_VERIFICATION_DEPTH = 6;
+
+    //! Initial distance of the aspiration window bounds to the expected score.
+    static const Score ASPIRATION_WINDOW = 50;
+    //! Factor a failed aspiration window bound is moved away from the expected score.
+    static const Score ASPIRATION_WINDOW_GROWTH = 4;
+    //! Bound distance beyond which the window is opened completely on that side.
+    static const Score ASPIRATION_WINDOW_LIMIT = 1000;
+
+    /**
+     * @brief Margin for delta pruning in quiescence search. Captures which
+     * can't raise the static evaluation above alpha by winning the victim
+     * plus this margin are skipped.
+     */
+    static const Score DELTA_PRUNING_MARGIN = 200;
+
+    //! Type of the legal turn list of TGameState, MoveList for GameState.
+    using TurnList = typename std::decay<decltype(legalMoves(std::declval<const TGameState&>()))>::type;
+    using Killers = typename MovePicker<TGameState, TurnList>::Killers;
+
+    //! State of a single searching thread.
+    struct SearchContext {
+        explicit SearchContext(bool helper)
+            : helper(helper), counters(), killers() {}
+
+        //! True for Lazy SMP helper threads.
+        bool helper;
+        //! Counters of this thread only.
+        PerfCounters counters;
+        //! Killer turns per ply of the current search.
+        std::vector<Killers> killers;
     };
-    
+
+    //! Logs the configuration of a search up to maxDepth plies.
+    void logSearchStart(size_t maxDepth) {
+        LOG(Logging::info) << "Starting " << maxDepth
+                           << " plies deep search. AB-pruning=" << AB_CUTOFF_ENABLED
+                           << " Move ordering=" << MOVE_ORDERING_ENABLED
+                           << " Transposition tables=" << TRANSPOSITION_TABLES_ENABLED
+                           << " PVS=" << PVS_ENABLED
+                           << " Quiescence=" << QUIESCENCE_SEARCH_ENABLED
+                           << " Null move=" << NULL_MOVE_ENABLED
+                           << " Threads=" << m_threads;
+    }
+
+    /**
+     * @brief Starts the Lazy SMP helper threads for a search of state and
+     * prepares the main thread's context.
+     * The helpers deepen on their own until stopHelpers is called.
+     */
+    void startHelpers(const TGameState& state, size_t maxDepth, SearchContext& context) {
+        m_stopHelpers = false;
+        context.killers.assign(maxDepth + 1, {{ Move(), Move() }});
+
+        // Every other helper starts one ply deeper than the main thread so
+        // the threads diverge and fill the table for each other.
+        m_helpers.assign(m_threads - 1, SearchContext(true));
+        m_helperThreads.clear();
+        for (size_t i = 0; i < m_helpers.size(); ++i) {
+            // Each helper gets a copy including the hash history so it
+            // sees the same repetitions as the main thread
+            m_helperThreads.emplace_back(&Negamax::helperSearch, this,
+                                         TGameState(state), maxDepth + (i + 1) % 2,
+                                         std::ref(m_helpers[i]));
+        }
+    }
+
+    //! Stops the helper threads and adds the counters of all threads to m_counters.
+    void stopHelpers(const SearchContext& context) {
+        m_stopHelpers = true;
+        for (std::thread& helperThread: m_helperThreads) {
+            helperThread.join();
+        }
+        m_helperThreads.clear();
+
+        m_counters += context.counters;
+        for (const SearchContext& helper: m_helpers) {
+            m_counters += helper.counters;
+        }
+        m_helpers.clear();
+    }
+
+    /**
+     * @brief Searches the root position within the given window on the
+     * main thread. The helpers keep running in the background.
+     * @return Result of the search. Its score is a bound if outside of
+     *         (alpha, beta).
+     */
+    NegamaxResult searchWindow(TGameState& state, SearchContext& context, size_t maxDepth,
+                               Score alpha, Score beta) {
+        LOG(Logging::debug) << "Searching window (" << alpha << ", " << beta << ")";
+        return search_recurse(state, context, 0, maxDepth, alpha, beta);
+    }
+
+    //! Sets the search duration and logs the result of a search started at start.
+    NegamaxResult finishSearch(NegamaxResult result,
+                               std::chrono::steady_clock::time_point start) {
+        m_counters.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+
+        if (m_abort) {
+            LOG(Logging::debug) << "Aborted without result";
+        } else {
+            LOG(Logging::debug) << result;
+        }
+        LOG(Logging::debug) << m_counters;
+        return result;
+    }
+
+    //! Returns true if the search of the given context should stop.
+    bool isAborted(const SearchContext& context) const {
+        return m_abort || (context.helper && m_stopHelpers);
+    }
+
+    /**
+     * @brief Runs a Lazy SMP helper thread.
+     * Iteratively deepens from the given depth until the main thread is done.
+     * The results are only used through the transposition table.
+     */
+    void helperSearch(TGameState state, size_t maxDepth, SearchContext& context) {
+        for (; maxDepth <= std::numeric_limits<uint8_t>::max() && !isAborted(context); ++maxDepth) {
+            // Killers of the shallower iteration stay good guesses
+            context.killers.resize(maxDepth + 1, {{ Move(), Move() }});
+            search_recurse(state, context, 0, maxDepth, MIN_SCORE, MAX_SCORE);
+        }
+    }
+
     /**
      * @brief Recursive Negamax search with optional Alpha-Beta cutoff.
      * @param state Game state to search from.
+     * @param context State of the searching thread.
      * @param depth Depth in plys already searched.
      * @param maxDepth Maximum depth in plys to search.
      * @param alpha Minimum score current (maximizing) player is assured of
      * @param beta Maximum score enemy (minimizing) player is assured of
+     * @param nullMoveAllowed False to not try a null move in this position.
      */
-    NegamaxResult search_recurse(TGameState state, size_t depth, const size_t maxDepth, Score alpha, Score beta) {
-        if (m_abort) return{ 0, boost::none };
+    NegamaxResult search_recurse(TGameState& state, SearchContext& context, size_t depth, const size_t maxDepth, Score alpha, Score beta,
+                                 bool nullMoveAllowed = true) {
+        if (isAborted(context)) return{ 0, boost::none };
 
         const size_t pliesLeft = maxDepth - depth;
 
-        if (state.isGameOver() || pliesLeft == 0) {
+        if (state.isGameOver()) {
             return { state.getScore(depth), boost::none };
         }
+
+        if (pliesLeft == 0) {
+            if (!QUIESCENCE_SEARCH_ENABLED) {
+                return { state.getScore(depth), boost::none };
+            }
+            // Without cutoffs in the main search the quiescence search must
+            // not return bounds as they would be taken for exact scores.
+            return { quiescence(state, context, depth,
+                                AB_CUTOFF_ENABLED ? alpha : MIN_SCORE,
+                                AB_CUTOFF_ENABLED ? beta : MAX_SCORE), boost::none };
+        }
+
+        if (depth > 0 && state.isRepetition()) {
+            // Either side can repeat the cycle, consider it a draw
+            return { 0, boost::none };
+        }
         
         const Score initialAlpha = alpha;
+        Move ttMove;
         
         if (TRANSPOSITION_TABLES_ENABLED) {
             auto tableEntry = m_transpositionTable.lookup(state.getHash());
+            if (tableEntry) {
+                // Even if too shallow the turn is a good first guess
+                ttMove = tableEntry->turn;
+            }
+
             if (tableEntry && tableEntry->depth >= pliesLeft) {
-                ++m_counters.transpositionTableHits;
+                ++context.counters.transpositionTableHits;
                 
                 // Deep enough to use directly
                 if (tableEntry->isExactBound()) {
                     // This is an actual result
-                    return { tableEntry->score, tableEntry->turn };
+                    return { tableEntry->score, unpackTurn(state, tableEntry->turn) };
                 } else if (tableEntry->isLowerBound()) {
                     // We have a lower bound, adjust alpha accordingly
                     alpha = std::max(alpha, tableEntry->score);
@@ -241,59 +489,110 @@ private:
                     // Upper or lower bound known for this position will
                     // trigger an alpha beta cutoff. No need to continue
                     // search.
-                    ++m_counters.cutoffs;
-                    return { tableEntry->score, tableEntry->turn };
+                    ++context.counters.cutoffs;
+                    return { tableEntry->score, unpackTurn(state, tableEntry->turn) };
                 }
             }
         }
 
-        NegamaxResult bestResult { MIN_SCORE, boost::none };
-        
-        std::vector<Turn> possibleTurns = state.getTurnList();
-        assert(possibleTurns.size() > 0);
-        
-        
-        std::vector<TGameState> consideredStates(possibleTurns.size(), state);
-        std::vector<Option> consideredOptions;
-        
-        consideredOptions.reserve(possibleTurns.size());
-        
-        for (unsigned int i = 0; i < possibleTurns.size(); ++i) {
-            // Need to apply all states at this point to be able to
-            // use their data for move ordering.
-            consideredStates[i].applyTurn(possibleTurns[i]);
-            consideredOptions.emplace_back(consideredStates[i],
-                                             possibleTurns[i],
-                                             estimateScoreFor(consideredStates[i],
-                                                             depth + 1));
+        if (NULL_MOVE_ENABLED && nullMoveAllowed && depth > 0
+                && beta < WIN_SCORE_THRESHOLD && beta > -WIN_SCORE_THRESHOLD
+                && !isInCheck(state)
+                && hasNonPawnMaterial(state) // Otherwise zugzwang is likely
+                && state.getScore(depth) >= beta) {
+            // If passing still fails high for us any real turn most likely
+            // does too. The null move gets a reduced search to be cheap.
+            const size_t reduction = pliesLeft > NULL_MOVE_DEEP_REDUCTION_DEPTH ? 3 : 2;
+
+            if (pliesLeft > reduction) {
+                ++context.counters.nullMoves;
+
+                state.makeTurn(Turn::pass(state.getNextPlayer()));
+                Score nullScore = -search_recurse(
+                            state, context, depth + 1, maxDepth - reduction,
+                            -beta, -beta + 1, false).score;
+                state.unmakeTurn();
+
+                if (isAborted(context)) return{ 0, boost::none };
+
+                if (nullScore >= beta) {
+                    bool verified = true;
+                    if (pliesLeft >= NULL_MOVE_VERIFICATION_DEPTH) {
+                        verified = search_recurse(
+                                    state, context, depth, maxDepth - reduction,
+                                    beta - 1, beta, false).score >= beta;
+
+                        if (isAborted(context)) return{ 0, boost::none };
+                    }
+
+                    if (verified) {
+                        ++context.counters.nullMoveCutoffs;
+                        // A mate found after passing isn't proven
+                        if (nullScore > WIN_SCORE_THRESHOLD) nullScore = beta;
+                        return { nullScore, boost::none };
+                    }
+                }
+            }
         }
+
+        NegamaxResult bestResult { MIN_SCORE, boost::none };
         
-        if (MOVE_ORDERING_ENABLED) {
-            std::sort(begin(consideredOptions), end(consideredOptions));
-        }
+        // Turns are generated and applied lazily in the order the picker
+        // hands them out. A cutoff skips the remaining turns. The game isn't
+        // over so there is at least one.
+        MovePicker<TGameState, TurnList> picker(
+                    state, ttMove, context.killers[depth], MOVE_ORDERING_ENABLED);
         
-        for (Option& option: consideredOptions) {
-            Turn& turn = *option.turn;
-            TGameState& newState = *option.state;
+        bool firstTurn = true;
+        while (const auto* nextTurn = picker.next()) {
+            const auto& turn = *nextTurn;
+            state.makeTurn(turn);
             
-            ++m_counters.nodes;
+            ++context.counters.nodes;
+
+            NegamaxResult result;
+            if (PVS_ENABLED && !firstTurn) {
+                // Assume the first turn was the best one and only try to
+                // prove this turn isn't better than alpha. Only if that
+                // fails the exact score has to be searched with the full window.
+                ++context.counters.nullWindowSearches;
+                result = -search_recurse(
+                            state, context, depth + 1, maxDepth,
+                            -alpha - 1, -alpha);
+
+                if (result.score > alpha && result.score < beta) {
+                    ++context.counters.researches;
+                    result = -search_recurse(
+                                state, context, depth + 1, maxDepth,
+                                -beta, -alpha);
+                }
+            } else {
+                result = -search_recurse(
+                            state, context, depth + 1, maxDepth,
+                            -beta, -alpha);
+            }
+            firstTurn = false;
 
-            NegamaxResult result = -search_recurse(
-                        newState, depth + 1, maxDepth,
-                        -beta, -alpha);
+            state.unmakeTurn();
 
             // Check if we improved upon previous turns
             if (result > bestResult) {
-                ++m_counters.updates;
+                ++context.counters.updates;
 
                 bestResult = result;
-                bestResult.turn = turn;
+                bestResult.turn = toTurn(state, turn);
             }
 
             alpha = std::max(alpha, result.score);
 
             if (AB_CUTOFF_ENABLED && alpha >= beta) {
-                ++m_counters.cutoffs;
+                ++context.counters.cutoffs;
+
+                if (MOVE_ORDERING_ENABLED &&
+                        captureOrderScore(state, turn) == NOT_A_CAPTURE) {
+                    storeKiller(context, depth, Move(turn));
+                }
+
                 // Enemy player won't let us reach a better score than
                 // his guaranteed beta score. No use in continuing to
                 // search this position as the results would be discarded
@@ -301,7 +600,7 @@ private:
                 break;
             }
 
-            if (m_abort) return{ 0, boost::none };
+            if (isAborted(context)) return{ 0, boost::none };
         }
         
         if (TRANSPOSITION_TABLES_ENABLED) {
@@ -309,9 +608,9 @@ private:
 
             TranspositionTableEntry entry;
             entry.score = bestResult.score;
-            entry.turn = *bestResult.turn;
+            entry.turn = Move(*bestResult.turn);
             entry.hash = state.getHash();
-            entry.depth = pliesLeft; // Our results comes from pliesLeft deep
+            entry.depth = static_cast<uint8_t>(pliesLeft); // Our results comes from pliesLeft deep
     
             if (bestResult.score <= initialAlpha) {
                 // Opponent might have omitted results with a lower score from
@@ -333,31 +632,115 @@ private:
     }
     
     /**
-     * @brief Estimates score for given state.
-     * Used for move ordering.
-     * @note Assumes state has opponent as next to move.
-     * @param state State to estimate.
-     * @param depth Depth in plies the given state has. Used to penalize
-     *              deep wins or shallow losses.
-     * @return Estimated score between WIN_SCORE and LOOSE_SCORE
+     * @brief Searches captures beyond the horizon until the position is quiet.
+     * Unless in check the player to move may stand pat with the static
+     * evaluation instead of capturing. Captures losing material by static
+     * exchange evaluation and captures which can't raise alpha are skipped.
+     * In check all evasions are searched.
+     * @return Score of the position. A bound if outside of (alpha, beta).
      */
-    Score estimateScoreFor(const TGameState& state, size_t depth) const {
-        // Note: Need to negate results as they are from the enemys POV
-        if (TRANSPOSITION_TABLES_ENABLED) {
-            auto entry = m_transpositionTable.lookup(state.getHash());
-            if (!entry) return -state.getScore(depth);
-            else if (entry->isUpperBound()) return -MIN_SCORE;
-            else return -entry->score;
-        } else {
-            // Greedy estimate based on next move
-            return -state.getScore(depth);
+    Score quiescence(TGameState& state, SearchContext& context, size_t depth, Score alpha, Score beta) {
+        if (isAborted(context)) return 0;
+
+        // Full game over detection would look for legal turns on top of the
+        // picker. Only the cheap draw rules are tested here, mate is left to
+        // the evasion search below.
+        if (isDrawByRule(state)) {
+            return 0;
+        }
+
+        const bool inCheck = isInCheck(state);
+
+        Score bestScore = MIN_SCORE;
+        if (!inCheck) {
+            bestScore = evaluate(state, depth);
+            if (bestScore >= beta) {
+                return bestScore;
+            }
+            alpha = std::max(alpha, bestScore);
+        }
+        const Score standPat = bestScore;
+
+        // In check all evasions are searched, otherwise only captures
+        static const Killers NO_KILLERS = {{ Move(), Move() }};
+        MovePicker<TGameState, TurnList> picker(
+                    state, Move(), NO_KILLERS, MOVE_ORDERING_ENABLED, !inCheck);
+
+        bool foundTurn = false;
+        while (const auto* nextTurn = picker.next()) {
+            const auto& turn = *nextTurn;
+            foundTurn = true;
+
+            if (!inCheck) {
+                if (standPat + captureGain(state, turn) + DELTA_PRUNING_MARGIN <= alpha
+                        && !turn.isPromotion()) {
+                    continue;
+                }
+                if (!seeGE(state, turn, 0)) {
+                    continue;
+                }
+            }
+
+            state.makeTurn(turn);
+            ++context.counters.quiescenceNodes;
+            const Score score = -quiescence(state, context, depth + 1, -beta, -alpha);
+            state.unmakeTurn();
+
+            if (isAborted(context)) return 0;
+
+            bestScore = std::max(bestScore, score);
+            alpha = std::max(alpha, score);
+
+            if (alpha >= beta) {
+                break;
+            }
+        }
+
+        if (inCheck && !foundTurn) {
+            // Checkmate, scored like ChessBoard::getScore does
+            return LOOSE_SCORE + static_cast<int>(depth);
+        }
+
+        return bestScore;
+    }
+
+    /**
+     * @brief Restores the full turn for a packed move from the given state.
+     * @return Matching legal turn. boost::none if the move isn't possible
+     *         in the state (e.g. on hash collisions).
+     */
+    boost::optional<Turn> unpackTurn(TGameState& state, Move move) const {
+        Turn turn;
+        if (!findLegalTurn(state, move, turn)) return boost::none;
+        return turn;
+    }
+
+    /**
+     * @brief Remembers a quiet turn which caused a cutoff at the given ply.
+     * Such turns are likely to cause cutoffs in sibling positions too.
+     */
+    void storeKiller(SearchContext& context, size_t depth, Move move) {
+        auto& killers = context.killers[depth];
+        if (killers[0] != move) {
+            killers[1] = killers[0];
+            killers[0] = move;
         }
     }
     
+    //! Transposition table shared by all searching threads.
     TranspositionTable m_transpositionTable;
+
+    //! Number of searching threads including the calling one.
+    const size_t m_threads;
     
     //! Abort flag
     std::atomic<bool> m_abort;
+    //! Tells helper threads the main thread finished its search.
+    std::atomic<bool> m_stopHelpers;
+    //! Contexts of the helper threads of the running search.
+    std::vector<SearchContext> m_helpers;
+    //! Helper threads of the running search.
+    std::vector<std::thread> m_helperThreads;
 
     Logging::Logger m_log;
 };
@@ -33,11 +33,13 @@
 #define TRANSPOSITION_TABLE_H
 
 #include <array>
+#include <atomic>
+#include <vector>
 #include <boost/optional.hpp>
 #include <sstream>
 
 #include "logic/ChessTypes.h"
-#include "logic/Turn.h"
+#include "logic/Move.h"
 
 /**
  * @brief Single entry in transposition table
@@ -45,17 +47,17 @@
  */
 struct TranspositionTableEntry {
     Hash hash; //!< Hash identifying position (might collide)
-    Turn turn; //!< Best turn from this position
     Score score; //!< Estimated score (@see boundType, @see depth)
+    Move turn; //!< Best turn from this position
     
     //! Describes the guarantees for the entry.
-    enum BoundType {
+    enum BoundType : uint8_t {
         LOWER, //!< Score is lower bound to score attainable by turn.
         UPPER, //!< Score is upper bound to score attainable by turn.
         EXACT  //!< Score is exactly what is attainable by turn.
     } boundType;
 
-    size_t depth; //!< Search depth used to evaluate position.
+    uint8_t depth; //!< Search depth in plies used to evaluate position.
     
     //! Returns true if entry score is lower bound to score attainable by turn.
     bool isLowerBound() const { return boundType == LOWER; }
@@ -71,7 +73,7 @@ struct TranspositionTableEntry {
         if (boundType == LOWER) ss << " LOWER";
         else if (boundType == UPPER) ss << " UPPER";
         else ss << " EXACT";
-        ss << " from depth " << depth;
+        ss << " from depth " << static_cast<int>(depth);
         
         return ss.str();
     }
@@ -82,6 +84,12 @@ struct TranspositionTableEntry {
  * Hashed on hash of transposition table entry. Offers limited internal
  * collision detection against class 2 errors by checking hash in entry
  * before returning. Class 1 errors should handled externally if problematic.
+ *
+ * The table can be shared by concurrently searching threads without locking.
+ * Each slot stores the entry packed into a single data word next to the
+ * hash xor-ed with that word. A slot torn by concurrent writes no longer
+ * verifies against its hash and is treated like a miss.
+ * @see http://www.craftychess.com/hyatt/hashing.html
  */
 class TranspositionTable {
 public:
@@ -106,12 +114,16 @@ public:
      * @param entry Entry to store.
      */
     void maybeUpdate(TranspositionTableEntry entry) {
-        TranspositionTableEntry &oldEntry = m_table[entry.hash % m_tablesize];
+        Slot &slot = m_table[entry.hash % m_tablesize];
 
-        if (oldEntry.hash == entry.hash && oldEntry.depth > entry.depth)
+        const uint64_t oldData = slot.data.load(std::memory_order_relaxed);
+        const Hash oldHash = slot.key.load(std::memory_order_relaxed) ^ oldData;
+        if (oldHash == entry.hash && unpackDepth(oldData) > entry.depth)
             return;
 
-        oldEntry = entry;
+        const uint64_t data = pack(entry);
+        slot.key.store(entry.hash ^ data, std::memory_order_relaxed);
+        slot.data.store(data, std::memory_order_relaxed);
     }
     
     /**
@@ -120,11 +132,13 @@ public:
      * @return Option to entry if in table. boost::none otherwise.
      */
     boost::optional<TranspositionTableEntry> lookup(Hash hash) const {
-        TranspositionTableEntry entry = m_table[hash % m_tablesize];
-        if (entry.hash != hash)
+        const Slot &slot = m_table[hash % m_tablesize];
+
+        const uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if ((slot.key.load(std::memory_order_relaxed) ^ data) != hash)
             return boost::none;
         
-        return entry;
+        return unpack(hash, data);
     }
 
     //! Returns the number of possible independent table entries.
@@ -133,9 +147,37 @@ public:
     }
     
 private:
-    
+    //! Table slot. key holds the entry hash xor-ed with data.
+    struct Slot {
+        std::atomic<uint64_t> key;
+        std::atomic<uint64_t> data;
+    };
+
+    /* Data word layout: bits 0-31 score, 32-47 turn, 48-55 bound, 56-63 depth */
+
+    static uint64_t pack(const TranspositionTableEntry& entry) {
+        return static_cast<uint64_t>(static_cast<uint32_t>(entry.score))
+             | (static_cast<uint64_t>(entry.turn.getData()) << 32)
+             | (static_cast<uint64_t>(entry.boundType) << 48)
+             | (static_cast<uint64_t>(entry.depth) << 56);
+    }
+
+    static TranspositionTableEntry unpack(Hash hash, uint64_t data) {
+        TranspositionTableEntry entry;
+        entry.hash = hash;
+        entry.score = static_cast<Score>(static_cast<uint32_t>(data));
+        entry.turn = Move::fromData(static_cast<uint16_t>(data >> 32));
+        entry.boundType = static_cast<TranspositionTableEntry::BoundType>((data >> 48) & 0xFF);
+        entry.depth = unpackDepth(data);
+        return entry;
+    }
+
+    static uint8_t unpackDepth(uint64_t data) {
+        return static_cast<uint8_t>(data >> 56);
+    }
+
     //! Hashtable with transpositions
-    std::vector<TranspositionTableEntry> m_table;
+    std::vector<Slot> m_table;
     
     //! Size set for this table
     const size_t m_tablesize;
@@ -48,13 +48,14 @@ string AIConfiguration::toString() const {
         << "  Opening book      : " << openingBook << endl
         << "  Max. turn time    : " << maximumTimeForTurnInSeconds << "s" << endl
         << "  Pondering         : " << ponderDuringOpposingPly << endl
-        << "  Max. search depth : " << maximumDepth << endl;
+        << "  Max. search depth : " << maximumDepth << endl
+        << "  Search threads    : " << searchThreads << endl;
 
     return ss.str();
 }
 
 AIConfiguration AIConfiguration::defaults() {
-    return { "Default", "resources/Book.bin", 30, true, 10000 };
+    return { "Default", "resources/Book.bin", 30, true, 10000, 1 };
 }
 
 GameConfiguration::GameConfiguration()
@@ -63,9 +64,9 @@ GameConfiguration::GameConfiguration()
     , initialGameStateFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1")
     , aiSelected(2)
     , ai({
-        AIConfiguration { "Simplistic Simon", "", 6, false, 3 },
-        AIConfiguration { "Bookish Bert", "resources/Book.bin", 8, false, 10000 },
-        AIConfiguration { "Pondering Paula", "resources/Book.bin", 10, true, 10000 }
+        AIConfiguration { "Simplistic Simon", "", 6, false, 3, 1 },
+        AIConfiguration { "Bookish Bert", "resources/Book.bin", 8, false, 10000, 1 },
+        AIConfiguration { "Pondering Paula", "resources/Book.bin", 10, true, 10000, 1 }
         }) {
     // Empty
 }
@@ -59,6 +59,8 @@ public:
     bool ponderDuringOpposingPly;
     //! Hard depth limit
     size_t maximumDepth;
+    //! Number of threads to search with
+    size_t searchThreads;
 
     static AIConfiguration defaults();
 
@@ -68,12 +70,17 @@ private:
     friend class boost::serialization::access;
 
     template <class Archive>
-    void serialize(Archive& ar, const unsigned int /*version*/) {
+    void serialize(Archive& ar, const unsigned int version) {
         ar & BOOST_SERIALIZATION_NVP(name);
         ar & BOOST_SERIALIZATION_NVP(openingBook);
         ar & BOOST_SERIALIZATION_NVP(maximumTimeForTurnInSeconds);
         ar & BOOST_SERIALIZATION_NVP(ponderDuringOpposingPly);
         ar & BOOST_SERIALIZATION_NVP(maximumDepth);
+        if (version > 1) {
+            ar & BOOST_SERIALIZATION_NVP(searchThreads);
+        } else {
+            searchThreads = 1;
+        }
     }
 };
 
@@ -141,7 +148,7 @@ private:
 };
 
 BOOST_CLASS_VERSION(GameConfiguration, 2)
-BOOST_CLASS_VERSION(AIConfiguration, 1)
+BOOST_CLASS_VERSION(AIConfiguration, 2)
 
 using GameConfigurationPtr = std::shared_ptr<GameConfiguration>;
 
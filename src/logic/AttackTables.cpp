@@ -0,0 +1,98 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "AttackTables.h"
+#include "ChessBoard.h"
+
+namespace {
+
+//! Returns the field offset by (fileStep, rankStep) or nothing if it is off the board.
+BitBoard offsetField(Field field, int fileStep, int rankStep) {
+    const int file = fileFor(field) + fileStep;
+    const int rank = rankFor(field) + rankStep;
+
+    if (file < A || file > H || rank < One || rank > Eight) {
+        return 0;
+    }
+
+    BitBoard bb = 0;
+    BIT_SET(bb, fieldFor(static_cast<File>(file), static_cast<Rank>(rank)));
+    return bb;
+}
+
+} // namespace
+
+const AttackTables::Tables AttackTables::m_tables;
+
+AttackTables::Tables::Tables() {
+    for (Field field = A1; field <= H8; field = nextField(field)) {
+        knight[field] = offsetField(field,  1,  2) | offsetField(field,  2,  1) |
+                        offsetField(field,  2, -1) | offsetField(field,  1, -2) |
+                        offsetField(field, -1, -2) | offsetField(field, -2, -1) |
+                        offsetField(field, -2,  1) | offsetField(field, -1,  2);
+
+        king[field] = offsetField(field, -1,  1) | offsetField(field,  0,  1) |
+                      offsetField(field,  1,  1) | offsetField(field,  1,  0) |
+                      offsetField(field,  1, -1) | offsetField(field,  0, -1) |
+                      offsetField(field, -1, -1) | offsetField(field, -1,  0);
+
+        pawn[White][field] = offsetField(field, -1,  1) | offsetField(field, 1,  1);
+        pawn[Black][field] = offsetField(field, -1, -1) | offsetField(field, 1, -1);
+    }
+
+    /* The magic tables may not be initialized yet, so walk the rays. The
+       intersection of the attacks of two aligned fields on each other is
+       exactly the ray between them, on an empty board it is the line. */
+    for (Field from = A1; from <= H8; from = nextField(from)) {
+        for (Field to = A1; to <= H8; to = nextField(to)) {
+            BitBoard bbFrom = 0, bbTo = 0;
+            BIT_SET(bbFrom, from);
+            BIT_SET(bbTo, to);
+
+            between[from][to] = 0;
+            line[from][to] = 0;
+
+            if (from == to) continue;
+
+            BitBoard (*slowAttacks)(Field, BitBoard) = nullptr;
+            if (MagicBitBoards::slowRookAttacks(from, 0) & bbTo) {
+                slowAttacks = &MagicBitBoards::slowRookAttacks;
+            } else if (MagicBitBoards::slowBishopAttacks(from, 0) & bbTo) {
+                slowAttacks = &MagicBitBoards::slowBishopAttacks;
+            } else {
+                continue;
+            }
+
+            between[from][to] = slowAttacks(from, bbTo) & slowAttacks(to, bbFrom);
+            line[from][to] = (slowAttacks(from, 0) & slowAttacks(to, 0)) | bbFrom | bbTo;
+        }
+    }
+}
@@ -0,0 +1,125 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef ATTACKTABLES_H
+#define ATTACKTABLES_H
+
+#include <array>
+#include "logic/ChessTypes.h"
+#include "logic/MagicBitBoards.h"
+
+/**
+ * @brief Precomputed attack sets of the non sliding pieces.
+ * Together with MagicBitBoards this allows looking up the attacks of
+ * any piece on any field without shifting and masking bitboards.
+ */
+class AttackTables {
+public:
+    //! Returns all fields attacked by a knight on the given field.
+    static BitBoard knightAttacks(Field field);
+    //! Returns all fields attacked by a king on the given field.
+    static BitBoard kingAttacks(Field field);
+    //! Returns all fields attacked by a pawn of player on the given field.
+    static BitBoard pawnAttacks(PlayerColor player, Field field);
+
+    //! Returns all fields attacked by any of the given pawns of player.
+    static BitBoard allPawnAttacks(PlayerColor player, BitBoard pawns);
+
+    //! Returns all fields attacked by the given piece on field.
+    static BitBoard attacks(Piece piece, Field field, BitBoard allPieces);
+
+    //! Returns the fields strictly between two fields on a common line. 0 if not aligned.
+    static BitBoard between(Field from, Field to);
+    /**
+     * @brief Returns the whole rank, file or diagonal through both fields
+     * from board edge to board edge. 0 if not aligned.
+     */
+    static BitBoard line(Field from, Field to);
+
+private:
+    class Tables {
+    public:
+        Tables();
+
+        std::array<BitBoard, NUM_FIELDS> knight;
+        std::array<BitBoard, NUM_FIELDS> king;
+        std::array<std::array<BitBoard, NUM_FIELDS>, NUM_PLAYERS> pawn;
+
+        std::array<std::array<BitBoard, NUM_FIELDS>, NUM_FIELDS> between;
+        std::array<std::array<BitBoard, NUM_FIELDS>, NUM_FIELDS> line;
+    };
+
+    const static Tables m_tables;
+};
+
+inline BitBoard AttackTables::knightAttacks(Field field) {
+    return m_tables.knight[field];
+}
+
+inline BitBoard AttackTables::kingAttacks(Field field) {
+    return m_tables.king[field];
+}
+
+inline BitBoard AttackTables::pawnAttacks(PlayerColor player, Field field) {
+    return m_tables.pawn[player][field];
+}
+
+inline BitBoard AttackTables::between(Field from, Field to) {
+    return m_tables.between[from][to];
+}
+
+inline BitBoard AttackTables::line(Field from, Field to) {
+    return m_tables.line[from][to];
+}
+
+inline BitBoard AttackTables::allPawnAttacks(PlayerColor player, BitBoard pawns) {
+    const BitBoard notFileA = 0xFEFEFEFEFEFEFEFEULL;
+    const BitBoard notFileH = 0x7F7F7F7F7F7F7F7FULL;
+
+    if (player == White) {
+        return ((pawns & notFileA) << 7) | ((pawns & notFileH) << 9);
+    }
+    return ((pawns & notFileA) >> 9) | ((pawns & notFileH) >> 7);
+}
+
+inline BitBoard AttackTables::attacks(Piece piece, Field field, BitBoard allPieces) {
+    switch (piece.type) {
+    case King:   return kingAttacks(field);
+    case Queen:  return MagicBitBoards::queenAttacks(field, allPieces);
+    case Bishop: return MagicBitBoards::bishopAttacks(field, allPieces);
+    case Knight: return knightAttacks(field);
+    case Rook:   return MagicBitBoards::rookAttacks(field, allPieces);
+    case Pawn:   return pawnAttacks(piece.player, field);
+    default:     return 0;
+    }
+}
+
+#endif // ATTACKTABLES_H
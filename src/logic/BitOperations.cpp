@@ -0,0 +1,108 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <sstream>
+#include <cstring>
+
+#include "BitOperations.h"
+
+#if defined(BITOPS_X64_GNUC)
+#include <cpuid.h>
+#endif
+
+namespace {
+
+//! Raw CPUID register values of one leaf.
+struct CpuidRegisters {
+    uint32_t eax, ebx, ecx, edx;
+};
+
+#if defined(BITOPS_X64_GNUC) || defined(BITOPS_X64_MSVC)
+
+CpuidRegisters cpuid(uint32_t leaf, uint32_t subleaf) {
+    CpuidRegisters r;
+#if defined(BITOPS_X64_MSVC)
+    int regs[4];
+    __cpuidex(regs, static_cast<int>(leaf), static_cast<int>(subleaf));
+    r.eax = regs[0]; r.ebx = regs[1]; r.ecx = regs[2]; r.edx = regs[3];
+#else
+    __cpuid_count(leaf, subleaf, r.eax, r.ebx, r.ecx, r.edx);
+#endif
+    return r;
+}
+
+#endif
+
+} // namespace
+
+BitOperations::CpuFeatures BitOperations::s_features = BitOperations::detectCpuFeatures();
+
+BitOperations::CpuFeatures BitOperations::detectCpuFeatures() {
+    CpuFeatures features;
+
+#if defined(BITOPS_X64_GNUC) || defined(BITOPS_X64_MSVC)
+    const CpuidRegisters leaf0 = cpuid(0, 0);
+    const uint32_t maxLeaf = leaf0.eax;
+
+    char vendor[13];
+    std::memcpy(vendor + 0, &leaf0.ebx, 4);
+    std::memcpy(vendor + 4, &leaf0.edx, 4);
+    std::memcpy(vendor + 8, &leaf0.ecx, 4);
+    vendor[12] = '\0';
+
+    if (maxLeaf < 1) return features;
+
+    const CpuidRegisters leaf1 = cpuid(1, 0);
+    features.popcnt = (leaf1.ecx & (1U << 23)) != 0;
+
+    uint32_t family = (leaf1.eax >> 8) & 0xF;
+    if (family == 0xF) family += (leaf1.eax >> 20) & 0xFF;
+
+    if (maxLeaf < 7) return features;
+
+    const CpuidRegisters leaf7 = cpuid(7, 0);
+    features.bmi2 = (leaf7.ebx & (1U << 8)) != 0;
+
+    // AMD implemented PEXT/PDEP in microcode before Zen 3 (family 19h).
+    // There it is much slower than the magic multiplication.
+    const bool isAmd = std::strcmp(vendor, "AuthenticAMD") == 0;
+    features.fastPext = features.bmi2 && !(isAmd && family < 0x19);
+#endif
+
+    return features;
+}
+
+std::string BitOperations::CpuFeatures::toString() const {
+    std::stringstream ss;
+    ss << "POPCNT=" << (popcnt ? "yes" : "no")
+       << " BMI2=" << (bmi2 ? (fastPext ? "yes" : "yes (slow PEXT)") : "no");
+    return ss.str();
+}
@@ -0,0 +1,194 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef BITOPERATIONS_H
+#define BITOPERATIONS_H
+
+#include <cassert>
+#include <string>
+#include "logic/ChessTypes.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <immintrin.h>
+#define BITOPS_X64_MSVC
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define BITOPS_X64_GNUC
+#endif
+
+/**
+ * @brief Bit manipulation primitives with runtime CPU dispatch.
+ * All instruction set specific variants are compiled into every binary. The
+ * CPU is queried via CPUID once during startup and each primitive then picks
+ * the fastest variant available on the host. The generic variants are always
+ * correct, so a primitive used before detection completed (e.g. during static
+ * initialization) merely runs slower.
+ */
+class BitOperations {
+public:
+    //! Instruction set extensions relevant for bitboard operations.
+    struct CpuFeatures {
+        CpuFeatures()
+            : popcnt(false), bmi2(false), fastPext(false) {}
+
+        bool popcnt;   //!< POPCNT instruction
+        bool bmi2;     //!< BMI2 (PEXT, PDEP, ...)
+        bool fastPext; //!< BMI2 with PEXT implemented in hardware (not microcoded)
+
+        std::string toString() const;
+    };
+
+    //! Queries the CPU for supported instruction set extensions.
+    static CpuFeatures detectCpuFeatures();
+    //! Returns the features detected during startup.
+    static const CpuFeatures& getCpuFeatures();
+
+    //! Returns the number of set bits.
+    static int popCount(BitBoard bb);
+    //! Returns the field of the most significant set bit. bb must not be 0.
+    static Field scanReverse(BitBoard bb);
+    /**
+     * @brief Gathers the bits of bb selected by mask into the low bits of the
+     * result (parallel bit extract, PEXT).
+     */
+    static BitBoard extractBits(BitBoard bb, BitBoard mask);
+    /**
+     * @brief extractBits without dispatch for callers which already decided
+     * on PEXT. Only call if BMI2 is available.
+     */
+    static BitBoard extractBitsBMI2(BitBoard bb, BitBoard mask);
+
+    /* Generic variants. Public for testing. */
+
+    static int popCountGeneric(BitBoard bb);
+    static Field scanReverseGeneric(BitBoard bb);
+    static BitBoard extractBitsGeneric(BitBoard bb, BitBoard mask);
+
+private:
+    //! Features used for dispatching. All false until detection ran.
+    static CpuFeatures s_features;
+};
+
+inline const BitOperations::CpuFeatures& BitOperations::getCpuFeatures() {
+    return s_features;
+}
+
+inline int BitOperations::popCountGeneric(BitBoard bb) {
+    // SWAR population count
+    bb = bb - ((bb >> 1) & 0x5555555555555555ULL);
+    bb = (bb & 0x3333333333333333ULL) + ((bb >> 2) & 0x3333333333333333ULL);
+    bb = (bb + (bb >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((bb * 0x0101010101010101ULL) >> 56);
+}
+
+inline Field BitOperations::scanReverseGeneric(BitBoard bb) {
+    assert(bb != 0);
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<Field>(63 - __builtin_clzll(bb));
+#elif defined(BITOPS_X64_MSVC)
+    unsigned long result;
+    _BitScanReverse64(&result, bb);
+    return static_cast<Field>(result);
+#elif defined(_MSC_VER)
+    unsigned long result;
+    if (_BitScanReverse(&result, static_cast<unsigned long>(bb >> 32)) == 0) {
+        _BitScanReverse(&result, static_cast<unsigned long>(bb));
+        return static_cast<Field>(result);
+    }
+    return static_cast<Field>(result + 32);
+#else
+    // Smear the MS1B down and count
+    bb |= bb >> 1;
+    bb |= bb >> 2;
+    bb |= bb >> 4;
+    bb |= bb >> 8;
+    bb |= bb >> 16;
+    bb |= bb >> 32;
+    return static_cast<Field>(popCountGeneric(bb) - 1);
+#endif
+}
+
+inline BitBoard BitOperations::extractBitsGeneric(BitBoard bb, BitBoard mask) {
+    BitBoard result = 0;
+    for (BitBoard bit = 1; mask != 0; bit <<= 1) {
+        if (bb & mask & (0 - mask)) result |= bit;
+        mask &= mask - 1;
+    }
+    return result;
+}
+
+/* The instruction set specific variants are emitted with inline assembly
+   (or intrinsics on MSVC) so they can be inlined into code compiled for the
+   baseline architecture and selected by a well predictable branch. */
+
+inline int BitOperations::popCount(BitBoard bb) {
+#if defined(BITOPS_X64_GNUC)
+    if (s_features.popcnt) {
+        BitBoard result;
+        __asm__("popcntq %1, %0" : "=r"(result) : "r"(bb));
+        return static_cast<int>(result);
+    }
+#elif defined(BITOPS_X64_MSVC)
+    if (s_features.popcnt) {
+        return static_cast<int>(__popcnt64(bb));
+    }
+#endif
+    return popCountGeneric(bb);
+}
+
+inline Field BitOperations::scanReverse(BitBoard bb) {
+    // BSR/CLZ is part of the x86-64 baseline. Nothing to dispatch.
+    return scanReverseGeneric(bb);
+}
+
+inline BitBoard BitOperations::extractBits(BitBoard bb, BitBoard mask) {
+    if (s_features.bmi2) {
+        return extractBitsBMI2(bb, mask);
+    }
+    return extractBitsGeneric(bb, mask);
+}
+
+inline BitBoard BitOperations::extractBitsBMI2(BitBoard bb, BitBoard mask) {
+#if defined(BITOPS_X64_GNUC)
+    BitBoard result;
+    __asm__("pextq %2, %1, %0" : "=r"(result) : "r"(bb), "r"(mask));
+    return result;
+#elif defined(BITOPS_X64_MSVC)
+    return _pext_u64(bb, mask);
+#else
+    return extractBitsGeneric(bb, mask);
+#endif
+}
+
+#endif // BITOPERATIONS_H
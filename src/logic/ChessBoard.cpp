@@ -30,6 +30,7 @@
     POSSIBILITY OF SUCH DAMAGE.
 */
 #include "ChessBoard.h"
+#include "AttackTables.h"
 #include "misc/helper.h"
 #include <iostream>
 using namespace std;
@@ -86,10 +87,14 @@ void ChessBoard::initBitBoards(std::array<Piece, 64> board) {
         Piece piece = board[field];
         if (piece.player != NoPlayer) {
             BIT_SET(m_bb[piece.player][piece.type], field);
+            m_board[field] = packPiece(piece);
+        } else {
+            m_board[field] = packPiece(Piece(NoPlayer, NoType));
         }
     }
 
     updateBitBoards();
+    updateAttacks(~(BitBoard)0, 0);
     
     m_hasher = IncrementalZobristHasher(*this);
 }
@@ -103,7 +108,38 @@ void ChessBoard::updateBitBoards() {
                              m_bb[Black][Rook]   | m_bb[Black][Pawn];
 }
 
+void ChessBoard::updateAttacks(BitBoard bbChangedFields, BitBoard bbAllPiecesBefore) {
+    const BitBoard bbAllPieces = m_bb[White][AllPieces] | m_bb[Black][AllPieces];
+    const BitBoard bbRookSliders = m_bb[White][Queen] | m_bb[White][Rook] |
+                                   m_bb[Black][Queen] | m_bb[Black][Rook];
+    const BitBoard bbBishopSliders = m_bb[White][Queen] | m_bb[White][Bishop] |
+                                     m_bb[Black][Queen] | m_bb[Black][Bishop];
+    BitBoard bbUpdate = bbChangedFields;
+
+    /* A sliding piece saw a changed field before the turn iff a slider of the
+       same kind on that field would have seen the piece. */
+    BitBoard bbFields = bbChangedFields;
+    while (bbFields != 0) {
+        const Field field = BB_SCAN(bbFields);
+        BIT_CLEAR(bbFields, field);
+
+        bbUpdate |= (MagicBitBoards::rookAttacks(field, bbAllPiecesBefore) & bbRookSliders) |
+                    (MagicBitBoards::bishopAttacks(field, bbAllPiecesBefore) & bbBishopSliders);
+    }
+
+    while (bbUpdate != 0) {
+        const Field field = BB_SCAN(bbUpdate);
+        BIT_CLEAR(bbUpdate, field);
+
+        m_attacksFrom[field] = BIT_ISSET(bbAllPieces, field)
+                ? AttackTables::attacks(getPieceAt(field), field, bbAllPieces)
+                : 0;
+    }
+}
+
 void ChessBoard::applyTurn(const Turn& turn) {
+    const BitBoard bbAllPiecesBefore = m_bb[White][AllPieces] | m_bb[Black][AllPieces];
+
     ++m_halfMoveClock;
     m_lastCapturedPiece = Piece(NoPlayer, NoType);
 
@@ -129,6 +165,15 @@ void ChessBoard::applyTurn(const Turn& turn) {
     updateEnPassantSquare(turn);
     updateBitBoards();
 
+    if (turn.action != Turn::Action::Pass && turn.action != Turn::Action::Forfeit) {
+        // Besides emptied and occupied fields the target field changes on captures
+        BitBoard bbChangedFields = bbAllPiecesBefore ^
+                (m_bb[White][AllPieces] | m_bb[Black][AllPieces]);
+        BIT_SET(bbChangedFields, turn.to);
+
+        updateAttacks(bbChangedFields, bbAllPiecesBefore);
+    }
+
     // select next player
     if (m_nextPlayer == White) {
         m_nextPlayer = Black;
@@ -139,6 +184,134 @@ void ChessBoard::applyTurn(const Turn& turn) {
     m_hasher.turnAppliedIncrement();
 }
 
+void ChessBoard::makeTurn(const Turn& turn, UndoInfo& undoOut) {
+    undoOut.score = m_evaluator.getScore(White);
+    undoOut.hashKeys = m_hasher.getKeys();
+    undoOut.lastCapturedPiece = m_lastCapturedPiece;
+    undoOut.enPassantSquare = m_enPassantSquare;
+    undoOut.halfMoveClock = m_halfMoveClock;
+    undoOut.shortCastleRight = m_shortCastleRight;
+    undoOut.longCastleRight = m_longCastleRight;
+    undoOut.kingInCheck = m_kingInCheck;
+    undoOut.checkmate = m_checkmate;
+    undoOut.stalemate = m_stalemate;
+
+    applyTurn(turn);
+}
+
+void ChessBoard::unmakeTurn(const Turn& turn, const UndoInfo& undo) {
+    const BitBoard bbAllPiecesAfter = m_bb[White][AllPieces] | m_bb[Black][AllPieces];
+    const PlayerColor player = turn.piece.player;
+    const PlayerColor opp = togglePlayerColor(player);
+
+    if (turn.action == Turn::Action::Move) {
+        BIT_CLEAR(m_bb[player][turn.piece.type], turn.to);
+        BIT_SET  (m_bb[player][turn.piece.type], turn.from);
+    } else if (turn.action == Turn::Action::Castle) {
+        BIT_CLEAR(m_bb[player][King], turn.to);
+        BIT_SET  (m_bb[player][King], turn.from);
+
+        Field from, to;
+        getCastleRookFields(turn.to, from, to);
+        BIT_CLEAR(m_bb[player][Rook], to);
+        BIT_SET  (m_bb[player][Rook], from);
+
+        m_board[to] = packPiece(Piece(NoPlayer, NoType));
+        m_board[from] = packPiece(Piece(player, Rook));
+    } else if (turn.isPromotion()) {
+        BIT_CLEAR(m_bb[player][getPieceAt(turn.to).type], turn.to);
+        BIT_SET  (m_bb[player][Pawn], turn.from);
+    }
+
+    if (turn.action != Turn::Action::Pass && turn.action != Turn::Action::Forfeit) {
+        m_board[turn.to] = packPiece(Piece(NoPlayer, NoType));
+        m_board[turn.from] = packPiece(turn.piece);
+    }
+
+    if (m_lastCapturedPiece.type != NoType) {
+        Field field = turn.to;
+        if (turn.piece.type == Pawn && turn.to == undo.enPassantSquare) {
+            // En passant, the captured pawn stood behind the target field
+            field = (opp == White) ? fieldFor(fileFor(turn.to), nextRank(rankFor(turn.to)))
+                                   : fieldFor(fileFor(turn.to), prevRank(rankFor(turn.to)));
+        }
+        BIT_SET(m_bb[opp][m_lastCapturedPiece.type], field);
+        m_board[field] = packPiece(m_lastCapturedPiece);
+    }
+
+    updateBitBoards();
+
+    if (turn.action != Turn::Action::Pass && turn.action != Turn::Action::Forfeit) {
+        // Same fields as in applyTurn, the roles of before and after swapped
+        BitBoard bbChangedFields = bbAllPiecesAfter ^
+                (m_bb[White][AllPieces] | m_bb[Black][AllPieces]);
+        BIT_SET(bbChangedFields, turn.to);
+
+        updateAttacks(bbChangedFields, bbAllPiecesAfter);
+    }
+
+    if (m_nextPlayer == White) {
+        --m_fullMoveClock;
+        m_nextPlayer = Black;
+    } else {
+        m_nextPlayer = White;
+    }
+
+    m_evaluator.restoreScore(undo.score);
+    m_hasher.restoreKeys(undo.hashKeys);
+    m_lastCapturedPiece = undo.lastCapturedPiece;
+    m_enPassantSquare = undo.enPassantSquare;
+    m_halfMoveClock = undo.halfMoveClock;
+    m_shortCastleRight = undo.shortCastleRight;
+    m_longCastleRight = undo.longCastleRight;
+    m_kingInCheck = undo.kingInCheck;
+    m_checkmate = undo.checkmate;
+    m_stalemate = undo.stalemate;
+}
+
+void ChessBoard::makeNullMove(UndoInfo& undoOut) {
+    undoOut.hashKeys = m_hasher.getKeys();
+    undoOut.lastCapturedPiece = m_lastCapturedPiece;
+    undoOut.enPassantSquare = m_enPassantSquare;
+    undoOut.halfMoveClock = m_halfMoveClock;
+    undoOut.kingInCheck = m_kingInCheck;
+    undoOut.checkmate = m_checkmate;
+    undoOut.stalemate = m_stalemate;
+
+    ++m_halfMoveClock;
+    m_lastCapturedPiece = Piece(NoPlayer, NoType);
+
+    if (m_enPassantSquare != ERR) {
+        m_hasher.clearedEnPassantSquare(m_enPassantSquare);
+        m_enPassantSquare = ERR;
+    }
+
+    if (m_nextPlayer == White) {
+        m_nextPlayer = Black;
+    } else {
+        ++m_fullMoveClock;
+        m_nextPlayer = White;
+    }
+    m_hasher.turnAppliedIncrement();
+}
+
+void ChessBoard::unmakeNullMove(const UndoInfo& undo) {
+    if (m_nextPlayer == White) {
+        --m_fullMoveClock;
+        m_nextPlayer = Black;
+    } else {
+        m_nextPlayer = White;
+    }
+
+    m_hasher.restoreKeys(undo.hashKeys);
+    m_lastCapturedPiece = undo.lastCapturedPiece;
+    m_enPassantSquare = undo.enPassantSquare;
+    m_halfMoveClock = undo.halfMoveClock;
+    m_kingInCheck = undo.kingInCheck;
+    m_checkmate = undo.checkmate;
+    m_stalemate = undo.stalemate;
+}
+
 void ChessBoard::applyMoveTurn(const Turn& turn) {
     const PlayerColor opp = togglePlayerColor(turn.piece.player);
     updateCastlingRights(turn);
@@ -152,7 +325,7 @@ void ChessBoard::applyMoveTurn(const Turn& turn) {
     if (BIT_ISSET(m_bb[opp][AllPieces], turn.to)) {
         capturePiece(turn);
 
-    } else if (m_enPassantSquare == turn.to) {
+    } else if (m_enPassantSquare == turn.to && turn.piece.type == Pawn) {
         const Rank rank = rankFor(m_enPassantSquare);
         const Piece capturedPiece(opp, Pawn);
         Field field;
@@ -164,6 +337,9 @@ void ChessBoard::applyMoveTurn(const Turn& turn) {
 
         addCapturedPiece(capturedPiece, field);
     }
+
+    m_board[turn.from] = packPiece(Piece(NoPlayer, NoType));
+    m_board[turn.to] = packPiece(turn.piece);
 }
 
 void ChessBoard::applyCastleTurn(const Turn& turn) {
@@ -180,26 +356,16 @@ void ChessBoard::applyCastleTurn(const Turn& turn) {
     m_hasher.moveIncrement(turn);
     m_evaluator.moveIncrement(turn);
 
-    if (turn.to == G1) { // short castle, white
-        from = H1;
-        to = F1;
-    } else if (turn.to == G8) { // short castle, black
-        from = H8;
-        to = F8;
-    } else if (turn.to == C1) { // long castle, white
-        from = A1;
-        to = D1;
-    } else if (turn.to == C8) { // long castle, black
-        from = A8;
-        to = D8;
-    } else {
-        to = from = ERR;
-        assert(false);
-    }
+    getCastleRookFields(turn.to, from, to);
 
     BIT_CLEAR(m_bb[turn.piece.player][Rook], from);
     BIT_SET  (m_bb[turn.piece.player][Rook], to);
 
+    m_board[turn.from] = packPiece(Piece(NoPlayer, NoType));
+    m_board[turn.to] = packPiece(turn.piece);
+    m_board[from] = packPiece(Piece(NoPlayer, NoType));
+    m_board[to] = packPiece(Piece(turn.piece.player, Rook));
+
     Turn rookTurn = Turn::move(Piece(turn.piece.player, Rook), from, to);
     m_hasher.moveIncrement(rookTurn);
     m_evaluator.moveIncrement(rookTurn);
@@ -208,28 +374,47 @@ void ChessBoard::applyCastleTurn(const Turn& turn) {
     assert(!BIT_ISSET(m_bb[togglePlayerColor(turn.piece.player)][AllPieces], to));
 }
 
+void ChessBoard::getCastleRookFields(Field kingTo, Field& rookFrom, Field& rookTo) {
+    if (kingTo == G1) { // short castle, white
+        rookFrom = H1;
+        rookTo = F1;
+    } else if (kingTo == G8) { // short castle, black
+        rookFrom = H8;
+        rookTo = F8;
+    } else if (kingTo == C1) { // long castle, white
+        rookFrom = A1;
+        rookTo = D1;
+    } else if (kingTo == C8) { // long castle, black
+        rookFrom = A8;
+        rookTo = D8;
+    } else {
+        rookTo = rookFrom = ERR;
+        assert(false);
+    }
+}
+
 void ChessBoard::applyPromotionTurn(const Turn& turn, const
                                     PieceType pieceType) {
     m_halfMoveClock = 0;
+    updateCastlingRights(turn);
 
     BIT_CLEAR(m_bb[turn.piece.player][turn.piece.type], turn.from);
     BIT_SET  (m_bb[turn.piece.player][pieceType],       turn.to);
 
     capturePiece(turn);
 
+    m_board[turn.from] = packPiece(Piece(NoPlayer, NoType));
+    m_board[turn.to] = packPiece(Piece(turn.piece.player, pieceType));
+
     m_evaluator.promotionIncrement(turn, pieceType);
     m_hasher.promotionIncrement(turn, pieceType);
 }
 
 void ChessBoard::capturePiece(const Turn& turn) {
-    const PlayerColor opp = togglePlayerColor(turn.piece.player);
+    const Piece capturedPiece = getPieceAt(turn.to);
 
-    for (int pieceType = King; pieceType < NUM_PIECETYPES; pieceType++) {
-        if (BIT_ISSET(m_bb[opp][pieceType], turn.to)) {
-            const Piece capturedPiece(opp, (PieceType) pieceType);
-            addCapturedPiece(capturedPiece, turn.to);
-            break;
-        }
+    if (capturedPiece.player == togglePlayerColor(turn.piece.player)) {
+        addCapturedPiece(capturedPiece, turn.to);
     }
 }
 
@@ -237,6 +422,7 @@ void ChessBoard::addCapturedPiece(const Piece capturedPiece, Field field) {
     m_halfMoveClock = 0;
 
     BIT_CLEAR(m_bb[capturedPiece.player][capturedPiece.type], field);
+    m_board[field] = packPiece(Piece(NoPlayer, NoType));
     m_lastCapturedPiece = capturedPiece;
 
     m_evaluator.captureIncrement(field, capturedPiece);
@@ -291,31 +477,216 @@ void ChessBoard::updateCastlingRights(const Turn& turn) {
         m_longCastleRight[Black]  = false;
     }
 
+    // Capturing a rook on its initial field voids the castling right too
+    if      (turn.to == A1) m_longCastleRight[White]  = false;
+    else if (turn.to == H1) m_shortCastleRight[White] = false;
+    else if (turn.to == A8) m_longCastleRight[Black]  = false;
+    else if (turn.to == H8) m_shortCastleRight[Black] = false;
+
     m_hasher.updateCastlingRights(
         prevShortCastleRight, prevLongCastleRight,
         m_shortCastleRight, m_longCastleRight
     );
 }
 
+BitBoard ChessBoard::getAttacks(PlayerColor player) const {
+    // Pawn attacks are cheaper to shift in bulk than to collect field by field
+    BitBoard bbAttacks = AttackTables::allPawnAttacks(player, m_bb[player][Pawn]);
+    BitBoard bbPieces = m_bb[player][King]   | m_bb[player][Queen] |
+                        m_bb[player][Bishop] | m_bb[player][Knight] |
+                        m_bb[player][Rook];
+
+    while (bbPieces != 0) {
+        const Field field = BB_SCAN(bbPieces);
+        BIT_CLEAR(bbPieces, field);
+
+        bbAttacks |= m_attacksFrom[field];
+    }
+
+    return bbAttacks;
+}
+
+BitBoard ChessBoard::getAttacksFrom(Field field) const {
+    return m_attacksFrom[field];
+}
+
+BitBoard ChessBoard::getAttackersTo(Field field, BitBoard bbOccupied) const {
+    const BitBoard bbRooks = m_bb[White][Rook] | m_bb[Black][Rook]
+                           | m_bb[White][Queen] | m_bb[Black][Queen];
+    const BitBoard bbBishops = m_bb[White][Bishop] | m_bb[Black][Bishop]
+                             | m_bb[White][Queen] | m_bb[Black][Queen];
+
+    return (AttackTables::pawnAttacks(Black, field) & m_bb[White][Pawn])
+         | (AttackTables::pawnAttacks(White, field) & m_bb[Black][Pawn])
+         | (AttackTables::knightAttacks(field) & (m_bb[White][Knight] | m_bb[Black][Knight]))
+         | (AttackTables::kingAttacks(field) & (m_bb[White][King] | m_bb[Black][King]))
+         | (MagicBitBoards::rookAttacks(field, bbOccupied) & bbRooks)
+         | (MagicBitBoards::bishopAttacks(field, bbOccupied) & bbBishops);
+}
+
+namespace {
+    //! Attackers in the order they join an exchange (least valuable first).
+    const std::array<PieceType, 6> SEE_ATTACKER_ORDER = {{
+        Pawn, Knight, Bishop, Rook, Queen, King
+    }};
+
+    inline Score seeValue(PieceType pieceType) {
+        return IncrementalMaterialAndPSTEvaluator::getPieceValue(pieceType);
+    }
+}
+
+PieceType ChessBoard::popLeastValuableAttacker(BitBoard bbAttackers,
+                                               PlayerColor player,
+                                               BitBoard& bbOccupied) const {
+    for (PieceType pieceType : SEE_ATTACKER_ORDER) {
+        const BitBoard bbCandidates = bbAttackers & m_bb[player][pieceType];
+        if (bbCandidates != 0) {
+            BIT_CLEAR(bbOccupied, BB_SCAN(bbCandidates));
+            return pieceType;
+        }
+    }
+    assert(false);
+    return NoType;
+}
+
+BitBoard ChessBoard::addXRayAttackers(Field field,
+                                      PieceType capturer,
+                                      BitBoard bbAttackers,
+                                      BitBoard bbOccupied) const {
+    // Only a capture along a line can uncover a slider behind the capturer
+    if (capturer == Pawn || capturer == Bishop || capturer == Queen) {
+        bbAttackers |= MagicBitBoards::bishopAttacks(field, bbOccupied)
+            & (m_bb[White][Bishop] | m_bb[Black][Bishop]
+             | m_bb[White][Queen] | m_bb[Black][Queen]);
+    }
+    if (capturer == Rook || capturer == Queen) {
+        bbAttackers |= MagicBitBoards::rookAttacks(field, bbOccupied)
+            & (m_bb[White][Rook] | m_bb[Black][Rook]
+             | m_bb[White][Queen] | m_bb[Black][Queen]);
+    }
+    return bbAttackers & bbOccupied;
+}
+
+Score ChessBoard::see(const Turn& turn) const {
+    if (!turn.isMove() && !turn.isPromotion()) return 0;
+
+    const PlayerColor player = turn.piece.player;
+    BitBoard bbOccupied = m_bb[White][AllPieces] | m_bb[Black][AllPieces];
+    BIT_CLEAR(bbOccupied, turn.from);
+
+    // Gains of each capture in the sequence from the view of the capturer
+    std::array<Score, 32> gain;
+    const Piece captured = getPieceAt(turn.to);
+    gain[0] = captured.type != NoType ? seeValue(captured.type) : 0;
+
+    if (turn.piece.type == Pawn && turn.to == m_enPassantSquare) {
+        const Field capturedPawn = static_cast<Field>(player == White ? turn.to - 8 : turn.to + 8);
+        BIT_CLEAR(bbOccupied, capturedPawn);
+        gain[0] = seeValue(Pawn);
+    }
+
+    Score onField = seeValue(turn.piece.type);
+    if (turn.isPromotion()) {
+        onField = seeValue(turn.getPromotionPieceType());
+        gain[0] += onField - seeValue(Pawn);
+    }
+
+    BitBoard bbAttackers = getAttackersTo(turn.to, bbOccupied) & bbOccupied;
+    PlayerColor side = togglePlayerColor(player);
+    size_t depth = 0;
+
+    while (depth + 1 < gain.size()) {
+        const BitBoard bbSideAttackers = bbAttackers & m_bb[side][AllPieces];
+        if (bbSideAttackers == 0) break;
+
+        const PieceType capturer = popLeastValuableAttacker(bbSideAttackers, side, bbOccupied);
+        if (capturer == King
+                && (bbAttackers & m_bb[togglePlayerColor(side)][AllPieces] & bbOccupied) != 0) {
+            // The king may not capture into a defended field
+            break;
+        }
+
+        ++depth;
+        gain[depth] = onField - gain[depth - 1];
+        onField = seeValue(capturer);
+
+        bbAttackers = addXRayAttackers(turn.to, capturer, bbAttackers, bbOccupied);
+        side = togglePlayerColor(side);
+    }
+
+    // Each side only continues the exchange if it does not lose by it
+    while (depth > 0) {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+        --depth;
+    }
+
+    return gain[0];
+}
+
+bool ChessBoard::seeGE(const Turn& turn, Score threshold) const {
+    if (!turn.isMove() && !turn.isPromotion()) return 0 >= threshold;
+
+    const PlayerColor player = turn.piece.player;
+    BitBoard bbOccupied = m_bb[White][AllPieces] | m_bb[Black][AllPieces];
+    BIT_CLEAR(bbOccupied, turn.from);
+
+    const Piece captured = getPieceAt(turn.to);
+    Score balance = captured.type != NoType ? seeValue(captured.type) : 0;
+
+    if (turn.piece.type == Pawn && turn.to == m_enPassantSquare) {
+        const Field capturedPawn = static_cast<Field>(player == White ? turn.to - 8 : turn.to + 8);
+        BIT_CLEAR(bbOccupied, capturedPawn);
+        balance = seeValue(Pawn);
+    }
+
+    Score onField = seeValue(turn.piece.type);
+    if (turn.isPromotion()) {
+        onField = seeValue(turn.getPromotionPieceType());
+        balance += onField - seeValue(Pawn);
+    }
+
+    // Even keeping the whole gain doesn't reach the threshold
+    Score swap = balance - threshold;
+    if (swap < 0) return false;
+
+    // Even losing the moved piece stays above the threshold
+    swap = onField - swap;
+    if (swap <= 0) return true;
+
+    BitBoard bbAttackers = getAttackersTo(turn.to, bbOccupied) & bbOccupied;
+    PlayerColor side = player;
+
+    // result is true while the side to capture next has to recapture to
+    // push the outcome below the threshold. swap is the margin that
+    // capture has to overcome.
+    bool result = true;
+    for (;;) {
+        side = togglePlayerColor(side);
+        const BitBoard bbSideAttackers = bbAttackers & m_bb[side][AllPieces];
+        if (bbSideAttackers == 0) break;
+
+        result = !result;
+
+        const PieceType capturer = popLeastValuableAttacker(bbSideAttackers, side, bbOccupied);
+        if (capturer == King) {
+            // The king may not capture into a defended field
+            const bool defended = (bbAttackers & m_bb[togglePlayerColor(side)][AllPieces] & bbOccupied) != 0;
+            return defended ? !result : result;
+        }
+
+        swap = seeValue(capturer) - swap;
+        if (swap < (result ? 1 : 0)) break;
+
+        bbAttackers = addXRayAttackers(turn.to, capturer, bbAttackers, bbOccupied);
+    }
+
+    return result;
+}
+
 std::array<Piece, 64> ChessBoard::getBoard() const {
     std::array<Piece, 64> board;
-    BitBoard allPieces = m_bb[White][AllPieces] | m_bb[Black][AllPieces];
-
     for (int field = 0; field < NUM_FIELDS; field++) {
-        if (BIT_ISSET(allPieces, field)) {
-            for (int player = White; player < NUM_PLAYERS; player++) {
-                for (int pieceType = King; pieceType < NUM_PIECETYPES; pieceType++) {
-                    if (BIT_ISSET(m_bb[player][pieceType], field)) {
-                        board[field] = Piece((PlayerColor)player, (PieceType)pieceType);
-
-                        pieceType = NUM_PIECETYPES;
-                        player = NUM_PLAYERS;
-                    }
-                }
-            }
-        } else {
-            board[field] = Piece(NoPlayer, NoType);
-        }
+        board[field] = unpackPiece(m_board[field]);
     }
 
     return board;
@@ -345,6 +716,10 @@ Score ChessBoard::getScore(PlayerColor color, size_t depth) const {
         }
     }
 
+    return getEvaluation(color);
+}
+
+Score ChessBoard::getEvaluation(PlayerColor color) const {
     return m_evaluator.getScore(color);
 }
 
@@ -352,6 +727,14 @@ Hash ChessBoard::getHash() const {
     return m_hasher.getHash();
 }
 
+Hash ChessBoard::getPawnHash() const {
+    return m_hasher.getPawnHash();
+}
+
+Hash ChessBoard::getMaterialHash() const {
+    return m_hasher.getMaterialHash();
+}
+
 int ChessBoard::getHalfMoveClock() const {
     return m_halfMoveClock;
 }
@@ -514,6 +897,67 @@ string ChessBoard::toFEN() const {
     return ss.str();
 }
 
+ChessBoard ChessBoard::fromPackedPosition(const PackedPosition& position) {
+    std::array<Piece, 64> board;
+    for (int field = 0; field < NUM_FIELDS; field++) {
+        board[field] = Piece(NoPlayer, NoType);
+    }
+
+    for (int player = White; player < NUM_PLAYERS; player++) {
+        for (int pieceType = King; pieceType < NUM_PIECETYPES; pieceType++) {
+            BitBoard bbPieces = position.pieces[pieceType] & position.players[player];
+            while (bbPieces != 0) {
+                const Field field = BB_SCAN(bbPieces);
+                BIT_CLEAR(bbPieces, field);
+                board[field] = Piece((PlayerColor)player, (PieceType)pieceType);
+            }
+        }
+    }
+
+    std::array<bool, NUM_PLAYERS> shortCastleRight;
+    std::array<bool, NUM_PLAYERS> longCastleRight;
+    for (PlayerColor player : { White, Black }) {
+        shortCastleRight[player] = position.castleRights & PackedPosition::shortCastleBit(player);
+        longCastleRight[player] = position.castleRights & PackedPosition::longCastleBit(player);
+    }
+
+    ChessBoard cb(board,
+                  static_cast<PlayerColor>(position.nextPlayer),
+                  shortCastleRight,
+                  longCastleRight,
+                  static_cast<Field>(position.enPassantSquare),
+                  position.halfMoveClock,
+                  position.fullMoveClock);
+    cb.m_lastCapturedPiece = unpackPiece(position.lastCapturedPiece);
+
+    return cb;
+}
+
+PackedPosition ChessBoard::toPackedPosition() const {
+    PackedPosition position;
+
+    for (int pieceType = King; pieceType < NUM_PIECETYPES; pieceType++) {
+        position.pieces[pieceType] = m_bb[White][pieceType] | m_bb[Black][pieceType];
+    }
+    position.players[White] = m_bb[White][AllPieces];
+    position.players[Black] = m_bb[Black][AllPieces];
+
+    position.halfMoveClock = static_cast<uint16_t>(m_halfMoveClock);
+    position.fullMoveClock = static_cast<uint16_t>(m_fullMoveClock);
+    position.nextPlayer = static_cast<uint8_t>(m_nextPlayer);
+
+    position.castleRights = 0;
+    for (PlayerColor player : { White, Black }) {
+        if (m_shortCastleRight[player]) position.castleRights |= PackedPosition::shortCastleBit(player);
+        if (m_longCastleRight[player])  position.castleRights |= PackedPosition::longCastleBit(player);
+    }
+
+    position.enPassantSquare = static_cast<uint8_t>(m_enPassantSquare);
+    position.lastCapturedPiece = packPiece(m_lastCapturedPiece);
+
+    return position;
+}
+
 Field ChessBoard::getEnPassantSquare() const {
     return m_enPassantSquare;
 }
@@ -558,7 +1002,8 @@ bool ChessBoard::isGameOver() const {
         return true;
     }
 
-    if (isDrawDueTo50MovesRule() || isStalemate()) {
+    if (isDrawDueTo50MovesRule() || isStalemate()
+            || isDrawDueToInsufficientMaterial()) {
         return true;
     }
 
@@ -569,6 +1014,42 @@ bool ChessBoard::isDrawDueTo50MovesRule() const {
     return getHalfMoveClock() >= 50 * 2;
 }
 
+bool ChessBoard::isKingAttacked(PlayerColor player) const {
+    return (m_bb[player][King] & getAttacks(togglePlayerColor(player))) != 0;
+}
+
+bool ChessBoard::hasNonPawnMaterial(PlayerColor player) const {
+    return (m_bb[player][AllPieces] & ~(m_bb[player][King] | m_bb[player][Pawn])) != 0;
+}
+
+bool ChessBoard::isDrawDueToInsufficientMaterial() const {
+    using Hasher = IncrementalZobristHasher;
+    static const std::array<Hash, 5> DEAD_MATERIAL = {{
+        Hasher::hashMaterial({ Piece(White, King), Piece(Black, King) }),
+        Hasher::hashMaterial({ Piece(White, King), Piece(Black, King), Piece(White, Bishop) }),
+        Hasher::hashMaterial({ Piece(White, King), Piece(Black, King), Piece(Black, Bishop) }),
+        Hasher::hashMaterial({ Piece(White, King), Piece(Black, King), Piece(White, Knight) }),
+        Hasher::hashMaterial({ Piece(White, King), Piece(Black, King), Piece(Black, Knight) })
+    }};
+    static const Hash BISHOPS_ONLY = Hasher::hashMaterial({
+        Piece(White, King), Piece(Black, King), Piece(White, Bishop), Piece(Black, Bishop)
+    });
+
+    const Hash material = m_hasher.getMaterialHash();
+    for (const Hash dead : DEAD_MATERIAL) {
+        if (material == dead) return true;
+    }
+
+    if (material == BISHOPS_ONLY) {
+        // Bishops on the same colored fields can never attack the other king
+        const BitBoard bbLightFields = 0x55AA55AA55AA55AAULL;
+        const BitBoard bbBishops = m_bb[White][Bishop] | m_bb[Black][Bishop];
+        return (bbBishops & bbLightFields) == 0 || (bbBishops & ~bbLightFields) == 0;
+    }
+
+    return false;
+}
+
 PlayerColor ChessBoard::getWinner() const {
     if (m_checkmate[White]) {
         return Black;
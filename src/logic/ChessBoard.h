@@ -38,49 +38,15 @@
 #include <string>
 
 #include "Turn.h"
+#include "PackedPosition.h"
 #include "IncrementalMaterialAndPSTEvaluator.h"
 #include "IncrementalZobristHasher.h"
+#include "BitOperations.h"
 
-#ifdef _MSC_VER
-#include <intrin.h>
-
-#ifdef _WIN64
-#pragma intrinsic(_BitScanReverse64)
-inline Field getFirstOccupiedField(BitBoard bb) {
-    assert(bb != 0);
-    assert(sizeof(Field) == sizeof(unsigned long));
-    unsigned long result;
-    _BitScanReverse64(&result, bb);
-    return static_cast<Field>(result);
-}
-
-#else //_WIN32
-#pragma intrinsic(_BitScanReverse)
-inline Field getFirstOccupiedField(BitBoard bb) {
-    assert(bb != 0);
-    assert(sizeof(Field) == sizeof(long));
-    unsigned long result;
-    if (_BitScanReverse(&result, bb >> 32) == 0) {
-        _BitScanReverse(&result, bb & 0xFFFFFFFF);
-        return static_cast<Field>(result);
-    }
-    return static_cast<Field>(result + 32);
-}
-
-#endif //_WIN64
-#elif defined(__GNUC__) || defined(__clang__)
-inline Field getFirstOccupiedField(BitBoard bb) {
-    assert(bb != 0);
-    assert(sizeof(Field) == sizeof(int));
-
-    return static_cast<Field>(63 - __builtin_clzll(bb));
-}
-#else
-// This shouldn't be used really. Too slow.
+//! Returns the field of the most significant set bit. bb must not be 0.
 inline Field getFirstOccupiedField(BitBoard bb) {
-    return static_cast<Field>(static_cast<int>(std::log2((double)bb)));
+    return BitOperations::scanReverse(bb);
 }
-#endif
 
 /* Some helpful macros for bit pushing */
 #define BB_SCAN(   bb)         getFirstOccupiedField(bb) /* returns the field of MS1B */
@@ -108,10 +74,75 @@ public:
                int halfMoveClock,
                int fullMoveClock);
     
+    /**
+     * @brief Everything applyTurn changes that can't be recalculated
+     * from the turn itself. Needed to take back a turn with unmakeTurn.
+     */
+    struct UndoInfo {
+        //! Evaluator score from white's perspective.
+        Score score;
+        IncrementalZobristHasher::Keys hashKeys;
+        Piece lastCapturedPiece;
+        Field enPassantSquare;
+        int halfMoveClock;
+        std::array<bool, NUM_PLAYERS> shortCastleRight;
+        std::array<bool, NUM_PLAYERS> longCastleRight;
+        std::array<bool, NUM_PLAYERS> kingInCheck;
+        std::array<bool, NUM_PLAYERS> checkmate;
+        bool stalemate;
+    };
+
     //! Applies the given turn on current chessboard.
     void applyTurn(const Turn& t);
+    /**
+     * @brief Applies the given turn and stores what is needed to take it back.
+     * @param undoOut Undo information to pass to unmakeTurn.
+     */
+    void makeTurn(const Turn& t, UndoInfo& undoOut);
+    /**
+     * @brief Takes back the given turn applied with makeTurn.
+     * @warning Turns have to be taken back in reverse order.
+     */
+    void unmakeTurn(const Turn& t, const UndoInfo& undo);
+    /**
+     * @brief Passes the turn to the opponent without moving a piece.
+     * Same as making Turn::pass() but only en passant rights, clocks,
+     * flags and hash change so nothing else is saved or recalculated.
+     * Used for null move pruning.
+     * @param undoOut Undo information to pass to unmakeNullMove.
+     */
+    void makeNullMove(UndoInfo& undoOut);
+    //! Takes back a null move made with makeNullMove.
+    void unmakeNullMove(const UndoInfo& undo);
     //! Returns the chessboard in array representation.
     std::array<Piece, 64> getBoard() const;
+    //! Returns the piece on the given field. Piece(NoPlayer, NoType) if empty.
+    Piece getPieceAt(Field field) const;
+    //! Returns all fields attacked by the pieces of player.
+    BitBoard getAttacks(PlayerColor player) const;
+    //! Returns all fields attacked by the piece on the given field. 0 if empty.
+    BitBoard getAttacksFrom(Field field) const;
+    /**
+     * @brief Returns the pieces of both players attacking the given field
+     * with the given occupation. Sliders are blocked by occupied fields only.
+     */
+    BitBoard getAttackersTo(Field field, BitBoard bbOccupied) const;
+
+    /**
+     * @brief Static exchange evaluation of the given turn.
+     * Plays out all captures on the target field, each side capturing
+     * with its least valuable attacker and being free to stop, and returns
+     * the resulting material balance from the view of the moving player.
+     * Sliders behind the capturing pieces (x-rays) join the exchange.
+     * @note Pins and checks are ignored. Non captures are evaluated too,
+     *       e.g. a queen moving to an attacked field is negative.
+     */
+    Score see(const Turn& turn) const;
+    /**
+     * @brief Returns true if see(turn) >= threshold.
+     * Cheaper than see as it stops as soon as the outcome is known.
+     */
+    bool seeGE(const Turn& turn, Score threshold) const;
 
     //! Returns true if black pieces are on the board.
     bool hasBlackPieces() const;
@@ -122,8 +153,14 @@ public:
 
     //! Returns the current estimated score.
     Score getScore(PlayerColor color, size_t depth = 0) const;
+    //! Returns the static evaluation. Unlike getScore the game over flags are ignored.
+    Score getEvaluation(PlayerColor color) const;
     //! Returns hash for current position
     Hash getHash() const;
+    //! Returns hash of the pawn and king placement for current position
+    Hash getPawnHash() const;
+    //! Returns hash of the material signature for current position
+    Hash getMaterialHash() const;
     //! Returns half move clock
     int getHalfMoveClock() const;
     //! Returns full move clock
@@ -143,6 +180,17 @@ public:
      */
     std::string toFEN() const;
 
+    //! Packs a piece into a single byte for the mailbox.
+    static uint8_t packPiece(Piece piece);
+    //! Restores a piece packed with packPiece.
+    static Piece unpackPiece(uint8_t packedPiece);
+
+    //! Creates a chessboard from a packed position.
+    static ChessBoard fromPackedPosition(const PackedPosition& position);
+
+    //! Returns a compact, trivially copyable snapshot of the board.
+    PackedPosition toPackedPosition() const;
+
     //! Returns the field where en-passant rights exist. ERR if none.
     Field getEnPassantSquare() const;
     //! Returns short castle rights for players.
@@ -152,6 +200,12 @@ public:
 
     //! Returns whether the king of the player is in check or not.
     std::array<bool, NUM_PLAYERS> getKingInCheck() const;
+    /**
+     * @brief Returns true if the king of player is attacked.
+     * Taken from the attack maps, so unlike getKingInCheck it is valid
+     * without turn generation.
+     */
+    bool isKingAttacked(PlayerColor player) const;
 
     //! Gameover-Flag for stalemate position (gameover, no winner).
     bool isStalemate() const;
@@ -161,6 +215,14 @@ public:
     bool isGameOver() const;
     //! Returns true if the game is draw due to the 50 moves rule
     bool isDrawDueTo50MovesRule() const;
+    /**
+     * @brief Returns true if neither player can checkmate anymore.
+     * Recognizes K vs K, KB vs K, KN vs K and KB vs KB with bishops on
+     * fields of the same color by the material signature.
+     */
+    bool isDrawDueToInsufficientMaterial() const;
+    //! Returns true if player has pieces other than king and pawns.
+    bool hasNonPawnMaterial(PlayerColor player) const;
     /**
     * @brief Returns the winner of the game.
     * Returns Player color or NoPlayer on draw.
@@ -186,6 +248,13 @@ protected:
     std::array<std::array<BitBoard,NUM_PIECETYPES+1>, NUM_PLAYERS> m_bb;
     //! Updates the helper bit boards.
     void updateBitBoards();
+    /**
+     * @brief Updates the attack maps after the occupation of the given
+     * fields changed. Recalculates the attacks of the pieces on these
+     * fields and of all sliding pieces whose rays touched them.
+     * @param bbAllPiecesBefore Occupation before the change.
+     */
+    void updateAttacks(BitBoard bbChangedFields, BitBoard bbAllPiecesBefore);
 
     //! Set or unset the kingInCheck-Flag.
     void setKingInCheck(PlayerColor player, bool kingInCheck);
@@ -204,6 +273,21 @@ private:
     void applyCastleTurn(const Turn& turn);
     //! Promotes a pawn to a given piece type (Queen | Bishop | Rook | Knight).
     void applyPromotionTurn(const Turn& turn, const PieceType pieceType);
+    //! Returns the rook fields of the castle turn with the king moving to kingTo.
+    static void getCastleRookFields(Field kingTo, Field& rookFrom, Field& rookTo);
+
+    /**
+     * @brief Returns the type of the least valuable of the given attackers
+     * of player and removes that attacker from bbOccupied.
+     */
+    PieceType popLeastValuableAttacker(BitBoard bbAttackers,
+                                       PlayerColor player,
+                                       BitBoard& bbOccupied) const;
+    //! Adds sliders uncovered by the capturer leaving and drops captured attackers.
+    BitBoard addXRayAttackers(Field field,
+                              PieceType capturer,
+                              BitBoard bbAttackers,
+                              BitBoard bbOccupied) const;
 
     //! Determines the type of a captured piece and takes it from the board.
     void capturePiece(const Turn& turn);
@@ -214,6 +298,11 @@ private:
     //! Checks whether the given turn affects castling rights and updates them accordingly.
     void updateCastlingRights(const Turn& turn);
 
+    //! Mailbox with the packed piece on each field, kept in sync with the bit boards.
+    std::array<uint8_t, NUM_FIELDS> m_board;
+    //! Fields attacked by the piece on each field (sliders blocked by any piece).
+    std::array<BitBoard, NUM_FIELDS> m_attacksFrom;
+
     //! King of player in check postion.
     std::array<bool, NUM_PLAYERS> m_kingInCheck;
     //! King of player is checkmate.
@@ -242,6 +331,19 @@ private:
     IncrementalZobristHasher m_hasher;
 };
 
+inline uint8_t ChessBoard::packPiece(Piece piece) {
+    return static_cast<uint8_t>(piece.player << 3 | piece.type);
+}
+
+inline Piece ChessBoard::unpackPiece(uint8_t packedPiece) {
+    return Piece(static_cast<PlayerColor>(packedPiece >> 3),
+                 static_cast<PieceType>(packedPiece & 0x7));
+}
+
+inline Piece ChessBoard::getPieceAt(Field field) const {
+    return unpackPiece(m_board[field]);
+}
+
 /* for debug purposes only */
 #define BB_SET( field) static_cast<BitBoard>(std::pow(2, (int)field)) /* returns the value 2^field */
 
@@ -0,0 +1,182 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <cstring>
+
+#include "FenParser.h"
+#include "ChessBoard.h"
+
+namespace {
+
+inline const char* skipSpaces(const char* cur, const char* end) {
+    while (cur != end && (*cur == ' ' || *cur == '\t')) ++cur;
+    return cur;
+}
+
+inline bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+} // namespace
+
+bool FenParser::parse(const char* begin, const char* end, PackedPosition& positionOut) {
+    std::memset(&positionOut, 0, sizeof(PackedPosition));
+    positionOut.fullMoveClock = 1;
+    positionOut.enPassantSquare = ERR;
+    positionOut.lastCapturedPiece = ChessBoard::packPiece(Piece(NoPlayer, NoType));
+
+    const char* cur = skipSpaces(begin, end);
+
+    // Piece placement, from rank eight down to rank one
+    int rank = Eight;
+    int file = A;
+    for (; cur != end && *cur != ' '; ++cur) {
+        const char c = *cur;
+        if (c == '/') {
+            if (file != NUM_FILES || rank == One) return false;
+            --rank;
+            file = A;
+            continue;
+        }
+        if (c >= '1' && c <= '8') {
+            file += c - '0';
+            if (file > NUM_FILES) return false;
+            continue;
+        }
+        if (file >= NUM_FILES) return false;
+
+        PieceType pieceType;
+        switch (c | 0x20) { // lower case
+        case 'k': pieceType = King;   break;
+        case 'q': pieceType = Queen;  break;
+        case 'b': pieceType = Bishop; break;
+        case 'n': pieceType = Knight; break;
+        case 'r': pieceType = Rook;   break;
+        case 'p': pieceType = Pawn;   break;
+        default: return false;
+        }
+        const PlayerColor player = (c & 0x20) ? Black : White;
+
+        const BitBoard bbField = static_cast<BitBoard>(1) << (rank * NUM_FILES + file);
+        positionOut.pieces[pieceType] |= bbField;
+        positionOut.players[player] |= bbField;
+        ++file;
+    }
+    if (rank != One || file != NUM_FILES) return false;
+
+    // Active player
+    cur = skipSpaces(cur, end);
+    if (cur == end) return false;
+    if (*cur == 'w') positionOut.nextPlayer = White;
+    else if (*cur == 'b') positionOut.nextPlayer = Black;
+    else return false;
+    ++cur;
+
+    // Castling rights
+    cur = skipSpaces(cur, end);
+    if (cur == end) return false;
+    if (*cur == '-') {
+        ++cur;
+    } else {
+        for (; cur != end && *cur != ' '; ++cur) {
+            switch (*cur) {
+            case 'K': positionOut.castleRights |= PackedPosition::shortCastleBit(White); break;
+            case 'Q': positionOut.castleRights |= PackedPosition::longCastleBit(White);  break;
+            case 'k': positionOut.castleRights |= PackedPosition::shortCastleBit(Black); break;
+            case 'q': positionOut.castleRights |= PackedPosition::longCastleBit(Black);  break;
+            default: return false;
+            }
+        }
+    }
+
+    // En passant square
+    cur = skipSpaces(cur, end);
+    if (cur == end) return false;
+    if (*cur == '-') {
+        ++cur;
+    } else {
+        if (end - cur < 2) return false;
+        const char f = cur[0];
+        const char r = cur[1];
+        if (f < 'a' || f > 'h' || (r != '3' && r != '6')) return false;
+        positionOut.enPassantSquare = static_cast<uint8_t>(fieldFor(static_cast<File>(f - 'a'),
+                                                                    static_cast<Rank>(r - '1')));
+        cur += 2;
+    }
+    if (cur != end && *cur != ' ' && *cur != '\t') return false;
+
+    // Either FEN clocks or EPD operations
+    cur = skipSpaces(cur, end);
+    if (cur != end && isDigit(*cur)) {
+        if (!parseNumber(cur, end, positionOut.halfMoveClock)) return false;
+        cur = skipSpaces(cur, end);
+        if (cur != end && !parseNumber(cur, end, positionOut.fullMoveClock)) return false;
+        return skipSpaces(cur, end) == end;
+    }
+
+    return parseEpdOperations(cur, end, positionOut);
+}
+
+bool FenParser::parseEpdOperations(const char* cur, const char* end, PackedPosition& positionOut) {
+    while ((cur = skipSpaces(cur, end)) != end) {
+        const char* opcode = cur;
+        while (cur != end && *cur != ' ' && *cur != ';') ++cur;
+        const size_t opcodeLength = cur - opcode;
+
+        cur = skipSpaces(cur, end);
+        if (opcodeLength == 4 && std::strncmp(opcode, "hmvc", 4) == 0) {
+            if (!parseNumber(cur, end, positionOut.halfMoveClock)) return false;
+        } else if (opcodeLength == 4 && std::strncmp(opcode, "fmvn", 4) == 0) {
+            if (!parseNumber(cur, end, positionOut.fullMoveClock)) return false;
+        }
+
+        // Skip the remaining operands, semicolons in strings don't count
+        bool inString = false;
+        while (cur != end && (inString || *cur != ';')) {
+            if (*cur == '"') inString = !inString;
+            ++cur;
+        }
+        if (cur != end) ++cur;
+    }
+    return true;
+}
+
+bool FenParser::parseNumber(const char*& cur, const char* end, uint16_t& numberOut) {
+    if (cur == end || !isDigit(*cur)) return false;
+
+    uint32_t number = 0;
+    for (; cur != end && isDigit(*cur); ++cur) {
+        number = number * 10 + (*cur - '0');
+        if (number > UINT16_MAX) return false;
+    }
+    numberOut = static_cast<uint16_t>(number);
+    return true;
+}
@@ -0,0 +1,66 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef FENPARSER_H
+#define FENPARSER_H
+
+#include "logic/PackedPosition.h"
+
+/**
+ * @brief Fast parser for positions in FEN or EPD notation.
+ * Writes the position straight into the bit boards of a PackedPosition
+ * without any allocations, hashing or turn generation. Unlike
+ * ChessBoard::fromFEN malformed input is detected and rejected.
+ * http://en.wikipedia.org/wiki/Forsyth%E2%80%93Edwards_Notation
+ * @see PositionLoader for loading whole files.
+ */
+class FenParser {
+public:
+    /**
+     * @brief Parses a single position.
+     * The clocks are read from the FEN fields following the en passant
+     * square or from the hmvc and fmvn operations of an EPD line. They
+     * default to 0 and 1 if missing.
+     * @param begin Start of the line.
+     * @param end End of the line (exclusive), must not contain line breaks.
+     * @param positionOut Parsed position. Undefined if parsing fails.
+     * @return True if a position was parsed.
+     */
+    static bool parse(const char* begin, const char* end, PackedPosition& positionOut);
+
+private:
+    //! Parses the operations of an EPD line looking for the clocks.
+    static bool parseEpdOperations(const char* cur, const char* end, PackedPosition& positionOut);
+    //! Parses an unsigned number of at most 65535 and advances cur behind it.
+    static bool parseNumber(const char*& cur, const char* end, uint16_t& numberOut);
+};
+
+#endif // FENPARSER_H
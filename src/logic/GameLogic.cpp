@@ -45,7 +45,9 @@ GameLogic::GameLogic(AbstractPlayerPtr white, AbstractPlayerPtr black,
     , m_abort(false)
     , m_white(white)
     , m_black(black)
-    , m_gameState(initialGameState)
+    , m_position(initialGameState.toPackedPosition())
+    , m_gameOver(initialGameState.isGameOver())
+    , m_winner(initialGameState.getWinner())
     , m_config(config)
     , m_log(initLogger("GameLogic")){
     assert(white != black);
@@ -86,18 +88,20 @@ void GameLogic::stop() {
 void GameLogic::run() {
     m_white->onSetColor(White);
     m_black->onSetColor(Black);
-    assert(m_gameState.getNextPlayer() == White);
+
+    GameState gameState = GameState::fromPackedPosition(m_position);
+    assert(gameState.getNextPlayer() == White);
 
     LOG(info) << "Game start";
     notify([&](AbstractGameObserverPtr& obs) {
-        obs->onGameStart(m_gameState, *m_config);
+        obs->onGameStart(gameState, *m_config);
     });
 
     wait(seconds(m_config->timeBetweenTurnsInSeconds));
 
-    while (!isGameOver()) {
+    while (!m_abort && !gameState.isGameOver()) {
         auto& currentPlayer = getCurrentPlayer();
-        const PlayerColor currentColor = m_gameState.getNextPlayer();
+        const PlayerColor currentColor = gameState.getNextPlayer();
 
         LOG(debug) << currentColor << "'s turn";
 
@@ -106,14 +110,14 @@ void GameLogic::run() {
         });
 
         LOG(trace) << "Asking for turn";
-        auto futureTurn = currentPlayer->doMakeTurn(m_gameState);
+        auto futureTurn = currentPlayer->doMakeTurn(gameState);
 
         Turn turn; // Default pass turn
 
         const seconds maximumTurnTime(m_config->maximumTurnTimeInSeconds);
 
         if (!wait_for(futureTurn, maximumTurnTime)) {
-            if (isGameOver()) {
+            if (m_abort) {
                 // Game aborted
                 LOG(info) << "Game aborted";
                 currentPlayer->doAbortTurn();
@@ -133,10 +137,13 @@ void GameLogic::run() {
 
         LOG(trace) << currentColor << "'s turn: " << turn;
 
-        m_gameState.applyTurn(turn);
+        gameState.applyTurn(turn);
+        m_position = gameState.toPackedPosition();
+        m_gameOver = gameState.isGameOver();
+        m_winner = gameState.getWinner();
 
         notify([&](AbstractGameObserverPtr& obs) {
-            obs->onTurnEnd(currentColor, turn, m_gameState);
+            obs->onTurnEnd(currentColor, turn, gameState);
         });
 
         LOG(debug) << currentColor << " ended its turn";
@@ -147,7 +154,7 @@ void GameLogic::run() {
 
     LOG(info) << "Game over";
     notify([&](AbstractGameObserverPtr& obs) {
-        obs->onGameOver(m_gameState, getWinner());
+        obs->onGameOver(gameState, getWinner());
     });
 }
 
@@ -164,16 +171,16 @@ void GameLogic::wait(std::chrono::milliseconds waitInMs) const {
 }
 
 bool GameLogic::isGameOver() const {
-    return m_gameState.isGameOver() || m_abort;
+    return m_abort || m_gameOver;
 }
 
 PlayerColor GameLogic::getWinner() const {
     if (m_abort) return NoPlayer;
 
-    return m_gameState.getWinner();
+    return m_winner;
 }
 
 AbstractPlayerPtr& GameLogic::getCurrentPlayer() {
-    return (m_gameState.getNextPlayer() == White) ? m_white : m_black;
+    return (m_position.nextPlayer == White) ? m_white : m_black;
 }
 
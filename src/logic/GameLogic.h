@@ -147,7 +147,12 @@ private:
     std::vector<AbstractGameObserverPtr> m_observers;
     AbstractPlayerPtr m_white;
     AbstractPlayerPtr m_black;
-    GameState m_gameState;
+    //! Current position of the game. The game loop works on a GameState built from it.
+    PackedPosition m_position;
+    //! Game over state of m_position. Updated whenever the game loop applies a turn.
+    bool m_gameOver;
+    //! Winner in m_position (@see m_gameOver)
+    PlayerColor m_winner;
     GameConfigurationPtr m_config;
     Logging::Logger m_log;
 };
@@ -31,28 +31,183 @@
 */
 #include "GameState.h"
 #include <algorithm>
+#include <cassert>
 
-GameState::GameState() {
+GameState::GameState()
+    : m_turnsGenerated(false)
+    , m_flagsUpdated(false)
+    , m_ply(0)
+    , m_hashCount(0)
+    , m_pliesFromNull(HASH_HISTORY_SIZE) {
     init();
 }
 
 GameState::GameState(const ChessBoard &chessBoard)
-    : m_chessBoard(chessBoard) {
+    : m_chessBoard(chessBoard)
+    , m_turnsGenerated(false)
+    , m_flagsUpdated(false)
+    , m_ply(0)
+    , m_hashCount(0)
+    , m_pliesFromNull(HASH_HISTORY_SIZE) {
     init();
 }
 
+GameState::GameState(const GameState& other)
+    : m_chessBoard(other.m_chessBoard)
+    , m_turnGen(other.currentTurnGen())
+    , m_turnsGenerated(other.m_turnsGenerated)
+    , m_flagsUpdated(other.m_flagsUpdated)
+    , m_ply(0)
+    , m_hashHistory(other.m_hashHistory)
+    , m_hashCount(other.m_hashCount)
+    , m_pliesFromNull(other.m_pliesFromNull) {
+    // Nothing
+}
+
+GameState& GameState::operator=(const GameState& other) {
+    if (this != &other) {
+        m_chessBoard = other.m_chessBoard;
+        m_turnGen = other.currentTurnGen();
+        m_turnsGenerated = other.m_turnsGenerated;
+        m_flagsUpdated = other.m_flagsUpdated;
+        m_ply = 0;
+        m_hashHistory = other.m_hashHistory;
+        m_hashCount = other.m_hashCount;
+        m_pliesFromNull = other.m_pliesFromNull;
+    }
+    return *this;
+}
+
 void GameState::init() {
     m_turnGen.initFlags(m_chessBoard);
-    m_turnGen.generateTurns(getNextPlayer(), m_chessBoard);
+    pushHash();
+}
+
+void GameState::pushHash() {
+    m_hashHistory[m_hashCount % HASH_HISTORY_SIZE] = getHash();
+    ++m_hashCount;
+}
+
+void GameState::updatePliesFromNull(const Turn& turn) {
+    if (turn.isPass()) {
+        m_pliesFromNull = 0;
+    } else if (m_pliesFromNull < HASH_HISTORY_SIZE) {
+        ++m_pliesFromNull;
+    }
+}
+
+TurnGenerator& GameState::currentTurnGen() const {
+    return (m_ply == 0) ? m_turnGen : *m_madeTurnGens[m_ply - 1];
+}
+
+void GameState::ensureTurnsGenerated() const {
+    if (!m_turnsGenerated) {
+        currentTurnGen().generateTurns(getNextPlayer(), m_chessBoard);
+        m_turnsGenerated = true;
+        m_flagsUpdated = true;
+    }
+}
+
+void GameState::ensureFlagsUpdated() const {
+    if (!m_flagsUpdated) {
+        // Stops at the first legal turn instead of generating all of them
+        currentTurnGen().updateFlags(getNextPlayer(), m_chessBoard);
+        m_flagsUpdated = true;
+    }
+}
+
+bool GameState::hasAnyLegalMove() const {
+    if (m_turnsGenerated) {
+        return !currentTurnGen().getMoveList().empty();
+    }
+    return currentTurnGen().hasAnyLegalMove(getNextPlayer(), m_chessBoard);
+}
+
+size_t GameState::countLegalMoves() const {
+    if (m_turnsGenerated) {
+        return currentTurnGen().getMoveList().size();
+    }
+    return currentTurnGen().countLegalMoves(getNextPlayer(), m_chessBoard);
+}
+
+void GameState::generateCaptures(MoveList& capturesOut) const {
+    currentTurnGen().generateCaptures(getNextPlayer(), m_chessBoard, capturesOut);
+}
+
+void GameState::generateQuiets(MoveList& quietsOut) const {
+    currentTurnGen().generateQuiets(getNextPlayer(), m_chessBoard, quietsOut);
+}
+
+bool GameState::isLegalMove(Move move) const {
+    return currentTurnGen().isLegalMove(getNextPlayer(), m_chessBoard, move);
 }
 
 std::vector<Turn> GameState::getTurnList() const {
-    return m_turnGen.getTurnList();
+    const MoveList& moves = getMoveList();
+
+    std::vector<Turn> turns;
+    turns.reserve(moves.size());
+    for (const Move move: moves) {
+        turns.push_back(move.toTurn(m_chessBoard));
+    }
+    return turns;
+}
+
+const MoveList& GameState::getMoveList() const {
+    ensureTurnsGenerated();
+    return currentTurnGen().getMoveList();
 }
 
 void GameState::applyTurn(const Turn& turn) {
     m_chessBoard.applyTurn(turn);
-    m_turnGen.generateTurns(getNextPlayer(), m_chessBoard);
+    m_turnsGenerated = false;
+    m_flagsUpdated = false;
+    updatePliesFromNull(turn);
+    pushHash();
+}
+
+void GameState::makeTurn(const Turn& turn) {
+    // Entries are reused so making a turn allocates nothing once warmed up
+    if (m_history.size() <= m_ply) {
+        m_history.emplace_back();
+        m_madeTurnGens.emplace_back(new TurnGenerator());
+    }
+
+    HistoryEntry& entry = m_history[m_ply];
+    entry.turn = turn;
+    entry.turnsGenerated = m_turnsGenerated;
+    entry.flagsUpdated = m_flagsUpdated;
+    entry.pliesFromNull = m_pliesFromNull;
+    if (turn.isPass()) {
+        m_chessBoard.makeNullMove(entry.undo);
+    } else {
+        m_chessBoard.makeTurn(turn, entry.undo);
+    }
+
+    ++m_ply;
+    m_turnsGenerated = false;
+    m_flagsUpdated = false;
+    updatePliesFromNull(turn);
+    pushHash();
+}
+
+void GameState::makeTurn(Move move) {
+    makeTurn(move.toTurn(m_chessBoard));
+}
+
+void GameState::unmakeTurn() {
+    assert(m_ply > 0);
+    --m_ply;
+    const HistoryEntry& entry = m_history[m_ply];
+    if (entry.turn.isPass()) {
+        m_chessBoard.unmakeNullMove(entry.undo);
+    } else {
+        m_chessBoard.unmakeTurn(entry.turn, entry.undo);
+    }
+    m_turnsGenerated = entry.turnsGenerated;
+    m_flagsUpdated = entry.flagsUpdated;
+    m_pliesFromNull = entry.pliesFromNull;
+    --m_hashCount;
 }
 
 PlayerColor GameState::getNextPlayer() const {
@@ -60,10 +215,21 @@ PlayerColor GameState::getNextPlayer() const {
 }
 
 const ChessBoard& GameState::getChessBoard() const {
+    // The check and game over flags of the board are only updated on demand
+    ensureFlagsUpdated();
     return m_chessBoard;
 }
 
+const ChessBoard& GameState::peekChessBoard() const {
+    return m_chessBoard;
+}
+
+bool GameState::isInCheck() const {
+    return m_chessBoard.isKingAttacked(getNextPlayer());
+}
+
 bool GameState::isGameOver() const {
+    ensureFlagsUpdated();
     return m_chessBoard.isGameOver();
 }
 
@@ -71,14 +237,42 @@ bool GameState::isDrawDueTo50MovesRule() const {
     return m_chessBoard.isDrawDueTo50MovesRule();
 }
 
+bool GameState::isDrawDueToInsufficientMaterial() const {
+    return m_chessBoard.isDrawDueToInsufficientMaterial();
+}
+
+bool GameState::isRepetition() const {
+    const Hash hash = getHash();
+    // The hash of the current position is the last one in the history
+    const size_t pliesBack = std::min({
+        static_cast<size_t>(m_chessBoard.getHalfMoveClock()),
+        m_hashCount - 1,
+        HASH_HISTORY_SIZE - 1,
+        m_pliesFromNull });
+
+    // A repetition needs at least two turns of each player
+    for (size_t plies = 4; plies <= pliesBack; plies += 2) {
+        if (m_hashHistory[(m_hashCount - 1 - plies) % HASH_HISTORY_SIZE] == hash) {
+            return true;
+        }
+    }
+    return false;
+}
+
 PlayerColor GameState::getWinner() const {
+    ensureFlagsUpdated();
     return m_chessBoard.getWinner();
 }
 
 Score GameState::getScore(size_t depth) const {
+    ensureFlagsUpdated();
     return m_chessBoard.getScore(m_chessBoard.getNextPlayer(), depth);
 }
 
+Score GameState::getEvaluation() const {
+    return m_chessBoard.getEvaluation(m_chessBoard.getNextPlayer());
+}
+
 Piece GameState::getLastCapturedPiece() const {
     return m_chessBoard.getLastCapturedPiece();
 }
@@ -95,7 +289,16 @@ Hash GameState::getHash() const {
     return m_chessBoard.getHash();
 }
 
+Hash GameState::getPawnHash() const {
+    return m_chessBoard.getPawnHash();
+}
+
+Hash GameState::getMaterialHash() const {
+    return m_chessBoard.getMaterialHash();
+}
+
 std::string GameState::toString() const {
+    ensureFlagsUpdated();
     return m_chessBoard.toString();
 }
 
@@ -106,3 +309,11 @@ GameState GameState::fromFEN(const std::string& fen) {
 std::string GameState::toFEN() const {
     return m_chessBoard.toFEN();
 }
+
+GameState GameState::fromPackedPosition(const PackedPosition& position) {
+    return GameState(ChessBoard::fromPackedPosition(position));
+}
+
+PackedPosition GameState::toPackedPosition() const {
+    return m_chessBoard.toPackedPosition();
+}
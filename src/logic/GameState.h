@@ -32,6 +32,10 @@
 #ifndef GAMESTATE_H
 #define GAMESTATE_H
 
+#include <array>
+#include <memory>
+#include <vector>
+
 #include "ChessTypes.h"
 #include "ChessBoard.h"
 #include "TurnGenerator.h"
@@ -45,16 +49,75 @@ class GameState {
 public:
     GameState();
     explicit GameState(const ChessBoard& chessBoard);
+    /**
+     * @brief Copies the current position and its turn list only.
+     * Turns made on other can't be taken back on the copy. The hash
+     * history is copied too so repetitions of earlier positions are still
+     * detected. Where only the position is needed use PackedPosition
+     * (@see toPackedPosition).
+     */
+    GameState(const GameState& other);
+    GameState& operator=(const GameState& other);
 
-    //! Returns a list with all possible and legal turns.
+    /**
+     * @brief Returns a list with all possible and legal turns.
+     * Unpacks getMoveList. Meant for players and the GUI, the search
+     * works on the packed moves.
+     */
     std::vector<Turn> getTurnList() const;
-    //! Applies the given turn on current chessboard.
+    /**
+     * @brief Returns all possible and legal turns as packed moves.
+     * Turns are generated on the first call for a position.
+     */
+    const MoveList& getMoveList() const;
+    /**
+     * @brief Applies the given turn on current chessboard.
+     * Turn generation and game over detection are deferred until the
+     * turn list, the game over state or the chessboard is requested.
+     */
     void applyTurn(const Turn& turn);
+    //! Returns true if there is a legal turn. Doesn't generate the turn list.
+    bool hasAnyLegalMove() const;
+    //! Returns the number of legal turns. Doesn't generate the turn list.
+    size_t countLegalMoves() const;
+    /**
+     * @brief Appends the legal captures and queen promotions to capturesOut.
+     * Doesn't generate the turn list.
+     */
+    void generateCaptures(MoveList& capturesOut) const;
+    /**
+     * @brief Appends the legal turns generateCaptures leaves out to quietsOut.
+     * Doesn't generate the turn list.
+     */
+    void generateQuiets(MoveList& quietsOut) const;
+    //! Returns true if move is a legal turn. Doesn't generate the turn list.
+    bool isLegalMove(Move move) const;
+    /**
+     * @brief Applies the given turn so it can be taken back with unmakeTurn.
+     * The turn lists of the positions before stay valid until their turns
+     * are taken back. Turn::pass() makes a null move.
+     */
+    void makeTurn(const Turn& turn);
+    //! Unpacks move for the current position and makes it (@see makeTurn).
+    void makeTurn(Move move);
+    /**
+     * @brief Takes back the last turn applied with makeTurn.
+     * @warning Turns applied with applyTurn can't be taken back.
+     */
+    void unmakeTurn();
 
     //! Return next player to make a turn.
     PlayerColor getNextPlayer() const;
     //! Provides access to the chessboard.
     const ChessBoard& getChessBoard() const;
+    /**
+     * @brief Provides access to the chessboard without updating its check
+     * and game over flags. For code only looking at pieces and attacks,
+     * it doesn't pay for looking for legal turns.
+     */
+    const ChessBoard& peekChessBoard() const;
+    //! Returns true if the next player is in check. Doesn't look for legal turns.
+    bool isInCheck() const;
     /**
      * @brief Returns the captured piece from the last turn or
      * Piece(NoPlayer, NoType) if no piece was captured
@@ -71,11 +134,28 @@ public:
 
     //! Returns true if the game is draw due to the 50 moves rule
     bool isDrawDueTo50MovesRule() const;
+    //! Returns true if the game is draw as no player can checkmate anymore
+    bool isDrawDueToInsufficientMaterial() const;
+    /**
+     * @brief Returns true if the current position occurred before with the
+     * same player to move. Only positions since the last capture or pawn
+     * move are considered as no earlier one can repeat.
+     */
+    bool isRepetition() const;
 
     //! Returns current score estimate from next players POV.
     Score getScore(size_t depth = 0) const;
+    /**
+     * @brief Returns the static evaluation for the next player.
+     * Unlike getScore game over isn't detected.
+     */
+    Score getEvaluation() const;
     //! Returns hash for current position
     Hash getHash() const;
+    //! Returns hash of the pawn and king placement for current position
+    Hash getPawnHash() const;
+    //! Returns hash of the material signature for current position
+    Hash getMaterialHash() const;
 
     /**
     * @brief Create a GameState from a Forsyth-Edwards Notation string.
@@ -91,6 +171,11 @@ public:
     */
     std::string toFEN() const;
 
+    //! Creates a GameState from a packed position.
+    static GameState fromPackedPosition(const PackedPosition& position);
+    //! Returns a compact, trivially copyable snapshot of the current position.
+    PackedPosition toPackedPosition() const;
+
     bool operator==(const GameState& other) const;
     bool operator!=(const GameState& other) const;
     std::string toString() const;
@@ -98,10 +183,66 @@ public:
 private:
     //! Initialize the turn generator with the given chessboard.
     void init();
-    //! Chessboard representation and logic.
-    ChessBoard m_chessBoard;
-    //! Turn generator and gameover detection.
-    TurnGenerator m_turnGen;
+    //! Appends the hash of the current position to the hash history.
+    void pushHash();
+    //! Counts the given turn for the plies since the last null move.
+    void updatePliesFromNull(const Turn& turn);
+    //! Returns the turn generator of the current position.
+    TurnGenerator& currentTurnGen() const;
+    /**
+     * @brief Generates the turns of the current position if not done yet.
+     * This also sets the check and game over flags of the chessboard.
+     */
+    void ensureTurnsGenerated() const;
+    //! Sets the check and game over flags of the chessboard if not done yet.
+    void ensureFlagsUpdated() const;
+
+    /**
+     * @brief Chessboard representation and logic. Mutable as its check and
+     * game over flags are only updated on demand by turn generation.
+     */
+    mutable ChessBoard m_chessBoard;
+    //! Turn generator and gameover detection of the initial position.
+    mutable TurnGenerator m_turnGen;
+    //! True if the turns of the current position were generated.
+    mutable bool m_turnsGenerated;
+    //! True if the chessboard flags of the current position are up to date.
+    mutable bool m_flagsUpdated;
+
+    //! A turn applied with makeTurn and what is needed to take it back.
+    struct HistoryEntry {
+        Turn turn;
+        ChessBoard::UndoInfo undo;
+        //! Whether the turns of the position before were generated.
+        bool turnsGenerated;
+        //! Whether the flags of the position before were up to date.
+        bool flagsUpdated;
+        //! Plies since the last null move in the position before.
+        size_t pliesFromNull;
+    };
+    //! Number of turns applied with makeTurn which weren't taken back yet.
+    size_t m_ply;
+    //! Made turns, the first m_ply entries are in use. Never shrinks.
+    std::vector<HistoryEntry> m_history;
+    /**
+     * @brief Turn generators of the positions after each made turn. They
+     * are kept on the heap so their turn lists stay valid while the vector
+     * grows. Never shrinks.
+     */
+    std::vector<std::unique_ptr<TurnGenerator>> m_madeTurnGens;
+
+    //! Number of hashes kept. Enough for the 50 moves rule.
+    static const size_t HASH_HISTORY_SIZE = 128;
+    //! Ring buffer with the hashes of the game's positions, current one last.
+    std::array<Hash, HASH_HISTORY_SIZE> m_hashHistory;
+    //! Number of hashes ever pushed to the hash history.
+    size_t m_hashCount;
+    /**
+     * @brief Plies since the last null move, at most HASH_HISTORY_SIZE.
+     * Positions before a null move aren't part of the game so
+     * isRepetition doesn't look back further.
+     */
+    size_t m_pliesFromNull;
 };
 
 
@@ -203,10 +203,18 @@ void IncrementalMaterialAndPSTEvaluator::promotionIncrement(const Turn& turn, co
     }
 }
 
+Score IncrementalMaterialAndPSTEvaluator::getPieceValue(PieceType pieceType) {
+    return PIECE_VALUES[pieceType];
+}
+
 Score IncrementalMaterialAndPSTEvaluator::getScore(PlayerColor color) const {
     return color == White ? m_estimatedScore : -m_estimatedScore;
 }
 
+void IncrementalMaterialAndPSTEvaluator::restoreScore(Score whiteScore) {
+    m_estimatedScore = whiteScore;
+}
+
 bool IncrementalMaterialAndPSTEvaluator::operator == (const IncrementalMaterialAndPSTEvaluator& other) const {
     return m_estimatedScore == other.m_estimatedScore;
 }
@@ -64,8 +64,13 @@ public:
     //! Gives a full estimate for the given board
     static Score estimateFullBoard(const std::array<Piece, 64> &board);
 
+    //! Returns the material value of the given piece type.
+    static Score getPieceValue(PieceType pieceType);
+
     //! Returns the score from the perspective of the given player color.
     Score getScore(PlayerColor color) const;
+    //! Resets the estimate to a score previously returned by getScore(White).
+    void restoreScore(Score whiteScore);
 
     bool operator==(const IncrementalMaterialAndPSTEvaluator& other) const;
 private:
@@ -180,6 +180,14 @@ IncrementalZobristHasher::HashConstants::HashConstants()
     , enPassantRights({
          0x70CC73D90BC26E24ULL, 0xE21A6B35DF0C3AD7ULL, 0x003A93D8B2806962ULL, 0x1C99DED33CB890A1ULL, 0xCF3145DE0ADD4289ULL, 0xD0E4427A5514FB72ULL, 0x77C621CC9FB3A483ULL, 0x67A34DAC4356550BULL,
     })
+    , material({{
+        {{ 0x6B66573521D5A686ULL, 0xF66F222465FC3179ULL, }}, // King
+        {{ 0x9137EA5306D246BCULL, 0xC6B0A7FD28D0BF49ULL, }}, // Queen
+        {{ 0x2F53298CE5E85BDCULL, 0xE2AB0AAE4ECE523AULL, }}, // Bishop
+        {{ 0x4018A3A3883FB0DBULL, 0x185061A5B43E8EDFULL, }}, // Knight
+        {{ 0x3F0F39B94BAA47D6ULL, 0xAE66FC5C298673CCULL, }}, // Rook
+        {{ 0x438DAF9F68E912EBULL, 0x7B60A9B6AAAD3ED7ULL, }}, // Pawn
+    }})
 {
     // Empty
 }
@@ -187,12 +195,16 @@ IncrementalZobristHasher::HashConstants::HashConstants()
 
 IncrementalZobristHasher::IncrementalZobristHasher()
     : m_hash(0)
+    , m_pawnHash(0)
+    , m_materialHash(0)
     , m_isEnPassantApplied(false) {
     // Empty
 }
 
 IncrementalZobristHasher::IncrementalZobristHasher(const ChessBoard &board)
     : m_hash(hashFullBoard(board))
+    , m_pawnHash(hashPawnStructure(board))
+    , m_materialHash(hashMaterial(board))
     , m_isEnPassantApplied(isPolyglotEnPassant(board)) {
     // Empty
 }
@@ -241,10 +253,72 @@ Hash IncrementalZobristHasher::hashFullBoard(const ChessBoard &board) {
     return hash;
 }
 
+Hash IncrementalZobristHasher::hashPawnStructure(const ChessBoard &board) {
+    Hash hash = 0;
+
+    const auto pieces = board.getBoard();
+    for (Field field = A1; field <= H8; field = nextField(field)) {
+        const Piece piece = pieces[field];
+        if (!isPawnStructurePiece(piece.type)) continue;
+        hash ^= m_hashConstants.forPieceSquare(piece.type, field, piece.player);
+    }
+
+    return hash;
+}
+
+Hash IncrementalZobristHasher::hashMaterial(const ChessBoard &board) {
+    Hash hash = 0;
+
+    const auto pieces = board.getBoard();
+    for (Field field = A1; field <= H8; field = nextField(field)) {
+        const Piece piece = pieces[field];
+        if (piece.type == NoType) continue;
+        hash += m_hashConstants.forMaterial(piece.type, piece.player);
+    }
+
+    return hash;
+}
+
+Hash IncrementalZobristHasher::hashMaterial(std::initializer_list<Piece> pieces) {
+    Hash hash = 0;
+    for (const Piece& piece : pieces) {
+        hash += m_hashConstants.forMaterial(piece.type, piece.player);
+    }
+    return hash;
+}
+
 Hash IncrementalZobristHasher::getHash() const {
     return m_hash;
 }
 
+Hash IncrementalZobristHasher::getPawnHash() const {
+    return m_pawnHash;
+}
+
+Hash IncrementalZobristHasher::getMaterialHash() const {
+    return m_materialHash;
+}
+
+IncrementalZobristHasher::Keys IncrementalZobristHasher::getKeys() const {
+    Keys keys;
+    keys.hash = m_hash;
+    keys.pawnHash = m_pawnHash;
+    keys.materialHash = m_materialHash;
+    keys.isEnPassantApplied = m_isEnPassantApplied;
+    return keys;
+}
+
+void IncrementalZobristHasher::restoreKeys(const Keys& keys) {
+    m_hash = keys.hash;
+    m_pawnHash = keys.pawnHash;
+    m_materialHash = keys.materialHash;
+    m_isEnPassantApplied = keys.isEnPassantApplied;
+}
+
+bool IncrementalZobristHasher::isPawnStructurePiece(PieceType pieceType) {
+    return pieceType == Pawn || pieceType == King;
+}
+
 
 
 void IncrementalZobristHasher::clearedEnPassantSquare(Field enPassantSquare) {
@@ -255,17 +329,34 @@ void IncrementalZobristHasher::clearedEnPassantSquare(Field enPassantSquare) {
 }
 
 void IncrementalZobristHasher::moveIncrement(const Turn& turn) {
-    m_hash ^= m_hashConstants.forPieceSquare(turn.piece.type, turn.from, turn.piece.player);
-    m_hash ^= m_hashConstants.forPieceSquare(turn.piece.type, turn.to, turn.piece.player);
+    const Hash from = m_hashConstants.forPieceSquare(turn.piece.type, turn.from, turn.piece.player);
+    const Hash to = m_hashConstants.forPieceSquare(turn.piece.type, turn.to, turn.piece.player);
+
+    m_hash ^= from ^ to;
+    if (isPawnStructurePiece(turn.piece.type)) {
+        m_pawnHash ^= from ^ to;
+    }
 }
 
 void IncrementalZobristHasher::captureIncrement(Field field, const Piece& capturedPiece) {
-    m_hash ^= m_hashConstants.forPieceSquare(capturedPiece.type, field, capturedPiece.player);
+    const Hash square = m_hashConstants.forPieceSquare(capturedPiece.type, field, capturedPiece.player);
+
+    m_hash ^= square;
+    if (isPawnStructurePiece(capturedPiece.type)) {
+        m_pawnHash ^= square;
+    }
+    m_materialHash -= m_hashConstants.forMaterial(capturedPiece.type, capturedPiece.player);
 }
 
 void IncrementalZobristHasher::promotionIncrement(const Turn& turn, PieceType targetType) {
-    m_hash ^= m_hashConstants.forPieceSquare(Pawn, turn.from, turn.piece.player);
+    const Hash pawn = m_hashConstants.forPieceSquare(Pawn, turn.from, turn.piece.player);
+
+    m_hash ^= pawn;
     m_hash ^= m_hashConstants.forPieceSquare(targetType, turn.to, turn.piece.player);
+    // The promoted piece is no longer part of the pawn structure
+    m_pawnHash ^= pawn;
+    m_materialHash -= m_hashConstants.forMaterial(Pawn, turn.piece.player);
+    m_materialHash += m_hashConstants.forMaterial(targetType, turn.piece.player);
 }
 
 void IncrementalZobristHasher::turnAppliedIncrement() {
@@ -326,5 +417,7 @@ bool IncrementalZobristHasher::isPolyglotEnPassant(const ChessBoard& board) {
 
 bool IncrementalZobristHasher::operator == (const IncrementalZobristHasher& other) const {
     return m_hash == other.m_hash
+        && m_pawnHash == other.m_pawnHash
+        && m_materialHash == other.m_materialHash
         && m_isEnPassantApplied == other.m_isEnPassantApplied;
 }
\ No newline at end of file
@@ -33,6 +33,7 @@
 #define INCREMENTALZOBRISTHASHER_H
 
 #include <array>
+#include <initializer_list>
 #include "logic/ChessTypes.h"
 
 class ChessBoard;
@@ -46,12 +47,37 @@ public:
     IncrementalZobristHasher();
     IncrementalZobristHasher(const ChessBoard& board);
     using Hash = uint64_t;
+
+    //! Everything turns change. Enough to take a turn back.
+    struct Keys {
+        Hash hash;
+        Hash pawnHash;
+        Hash materialHash;
+        bool isEnPassantApplied;
+    };
     
     //! Gives a full estimate for the given board
     static Hash hashFullBoard(const ChessBoard& board);
+    //! Calculates the pawn structure key (pawns and kings) of the given board
+    static Hash hashPawnStructure(const ChessBoard& board);
+    //! Calculates the material signature key of the given board
+    static Hash hashMaterial(const ChessBoard& board);
+    //! Calculates the material signature key of a board with the given pieces
+    static Hash hashMaterial(std::initializer_list<Piece> pieces);
     
     //! Returns the current zobrist hash
     Hash getHash() const;
+    //! Returns the zobrist key of the pawn and king placement only
+    Hash getPawnHash() const;
+    /**
+     * @brief Returns a key for the number of pieces of each type and color.
+     * Positions with equal material share a key independent of placement.
+     */
+    Hash getMaterialHash() const;
+    //! Returns the current keys.
+    Keys getKeys() const;
+    //! Resets the hasher to keys previously returned by getKeys.
+    void restoreKeys(const Keys& keys);
 
     //! Called when the en passant field is cleared.
     void clearedEnPassantSquare(Field enPassantSquare);
@@ -83,7 +109,12 @@ private:
      */
     static bool isPolyglotEnPassant(const ChessBoard& board);
 
+    //! Returns true if the type is part of the pawn structure key
+    static bool isPawnStructurePiece(PieceType pieceType);
+
     Hash m_hash;
+    Hash m_pawnHash;
+    Hash m_materialHash;
     bool m_isEnPassantApplied;
     
     class HashConstants {
@@ -112,6 +143,14 @@ private:
             return player == White ? sideToMove : 0ULL;
         }
 
+        /**
+         * @brief Material keys are additive: Each piece adds the constant
+         * of its type and color, so the key only depends on the piece counts.
+         */
+        inline Hash forMaterial(PieceType pieceType, PlayerColor playerColor) const {
+            return material[pieceType][playerColor];
+        }
+
     private:
         std::array<std::array<std::array<Hash, NUM_FIELDS>, NUM_PLAYERS>, NUM_PIECETYPES> pieceSquares;
         
@@ -120,6 +159,8 @@ private:
         std::array<Hash, NUM_PLAYERS> castlingRightsLong;
         
         std::array<Hash, NUM_FILES> enPassantRights;
+
+        std::array<std::array<Hash, NUM_PLAYERS>, NUM_PIECETYPES> material;
     };
     
     const static HashConstants m_hashConstants;
@@ -0,0 +1,176 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "MagicBitBoards.h"
+#include "ChessBoard.h"
+#include "BitOperations.h"
+
+namespace {
+
+/**
+ * @brief Fixed shift rook magics indexed by Field.
+ * @note Generated by magicgen. Do not edit by hand.
+ */
+const std::array<BitBoard, NUM_FIELDS> ROOK_MAGICS = {{
+    0x80800040028C5060ULL, 0x10C0004120001000ULL, 0x0C80200080081000ULL, 0x0080080080100004ULL,
+    0x02800C0012802800ULL, 0x020002000B342810ULL, 0x0400208801104402ULL, 0x02000E0080294401ULL,
+    0x0008800088C00120ULL, 0x0110808040002000ULL, 0x0000801000200080ULL, 0x0408808008001000ULL,
+    0x1040800402080080ULL, 0x0098800400800200ULL, 0x4401000401000200ULL, 0x0400800A8005E100ULL,
+    0x1020208000804000ULL, 0x2910004020004000ULL, 0x09A0120020420086ULL, 0x0210010010090420ULL,
+    0x0004050010880100ULL, 0x4804808002000400ULL, 0x2900040088010210ULL, 0x1012020000410084ULL,
+    0x8100802080004000ULL, 0x0140100040200040ULL, 0x0000200300410010ULL, 0xA104100100082100ULL,
+    0x0010080080800400ULL, 0x0042020080040080ULL, 0x0B11A80C00108201ULL, 0x2001008200204104ULL,
+    0x2008844008800030ULL, 0x0460401000402000ULL, 0x08C3001241002001ULL, 0x0801100109002102ULL,
+    0x1900100801000500ULL, 0x1800020080800400ULL, 0x0028011004000802ULL, 0x0201002187000042ULL,
+    0x0008204000948000ULL, 0x0120004010004020ULL, 0x0010040800202000ULL, 0x800840200A020010ULL,
+    0x0000080004008080ULL, 0x0002000400808002ULL, 0x3082000401820008ULL, 0x0000640D40A20003ULL,
+    0x04E0400020800180ULL, 0x8042401004200440ULL, 0x0084100020008880ULL, 0x0324215900900100ULL,
+    0x1008000491000900ULL, 0x2409000804002300ULL, 0x9224800100020080ULL, 0x0020010400804200ULL,
+    0x4040800021001041ULL, 0x800C830012002042ULL, 0xE002218008104202ULL, 0x02E120C815100101ULL,
+    0x0002000810200402ULL, 0x0002001004010802ULL, 0x0124021090082104ULL, 0x00000A4410210082ULL
+}};
+
+/**
+ * @brief Fixed shift bishop magics indexed by Field.
+ * @note Generated by magicgen. Do not edit by hand.
+ */
+const std::array<BitBoard, NUM_FIELDS> BISHOP_MAGICS = {{
+    0x4002080808024242ULL, 0x0004140810411808ULL, 0x00104080A1009200ULL, 0x34020A020B000410ULL,
+    0x0010882000420002ULL, 0x10842420480400C0ULL, 0x0001288A20200800ULL, 0x0004840049046008ULL,
+    0x0003C00882440040ULL, 0x0010180A082201A4ULL, 0x0100420401002280ULL, 0x0508040408800040ULL,
+    0x08000202110000A0ULL, 0x0008044120104410ULL, 0x000C0C04020806C2ULL, 0x8040008400821000ULL,
+    0x0044041024300411ULL, 0x0004520208020400ULL, 0x0628109000404208ULL, 0x1108000C02102300ULL,
+    0xC000840C00A00124ULL, 0x20A1014A01011908ULL, 0x0301000044022041ULL, 0x00A080084200900AULL,
+    0x01200800243004C0ULL, 0x2259180004101400ULL, 0x0708900902042200ULL, 0x70D0040010401020ULL,
+    0x8001001011004000ULL, 0x411048800300A000ULL, 0x0082024602091001ULL, 0x8C0100A803042101ULL,
+    0x0024422000400440ULL, 0x0201140310204802ULL, 0x2024002084041100ULL, 0x0040020080180080ULL,
+    0x20102202000C2008ULL, 0x2102081040020040ULL, 0x00088A0408808891ULL, 0x1208908100020110ULL,
+    0x0102394440222000ULL, 0x0084008405C11004ULL, 0x00000A0090004A00ULL, 0x9100C04202200800ULL,
+    0x480070520080A810ULL, 0x0008500041900200ULL, 0x00C8020404280840ULL, 0x00080944002A2880ULL,
+    0x00A2120220044004ULL, 0x4000808410020004ULL, 0x06000020AC100280ULL, 0x1A010008C20A0804ULL,
+    0x0020001202020008ULL, 0x02204444A8160400ULL, 0x1291040104042081ULL, 0x0024010405120102ULL,
+    0x1022002488082813ULL, 0x4004008084300200ULL, 0x40C0008044140400ULL, 0x2022002103048800ULL,
+    0x80A000014008B200ULL, 0x8001100A10300082ULL, 0x2140108342140400ULL, 0x80122410043100A0ULL
+}};
+
+//! Walks from field in direction (fileStep, rankStep) until a piece or the board edge is hit.
+BitBoard walkRay(Field field, int fileStep, int rankStep, BitBoard allPieces, bool withEdges) {
+    BitBoard bb = 0;
+    int file = fileFor(field) + fileStep;
+    int rank = rankFor(field) + rankStep;
+
+    while (file >= A && file <= H && rank >= One && rank <= Eight) {
+        const int nextFile = file + fileStep;
+        const int nextRank = rank + rankStep;
+        const bool isEdge = nextFile < A || nextFile > H || nextRank < One || nextRank > Eight;
+        if (isEdge && !withEdges) break;
+
+        const Field cur = fieldFor(static_cast<File>(file), static_cast<Rank>(rank));
+        BIT_SET(bb, cur);
+        if (BIT_ISSET(allPieces, cur)) break;
+
+        file = nextFile;
+        rank = nextRank;
+    }
+
+    return bb;
+}
+
+} // namespace
+
+/**
+ * @brief Enumerates every subset of each field mask (Carry-Rippler) and stores
+ * its attack set at the index the magic (or PEXT) maps it to.
+ */
+template <size_t TABLE_SIZE>
+void MagicBitBoards::initMagics(std::array<Magic, NUM_FIELDS>& magics,
+                                std::array<BitBoard, TABLE_SIZE>& attacks,
+                                const std::array<BitBoard, NUM_FIELDS>& magicNumbers,
+                                BitBoard (*mask)(Field),
+                                BitBoard (*slowAttacks)(Field, BitBoard),
+                                bool usePext) {
+    unsigned int offset = 0;
+    attacks.fill(0);
+
+    for (Field field = A1; field <= H8; field = nextField(field)) {
+        Magic& m = magics[field];
+        m.mask = mask(field);
+        m.magic = magicNumbers[field];
+        m.shift = 64 - BitOperations::popCount(m.mask);
+        m.offset = offset;
+
+        BitBoard subset = 0;
+        do {
+            const BitBoard attack = slowAttacks(field, subset);
+            const size_t index = m.index(subset, usePext);
+            assert(attacks[index] == 0 || attacks[index] == attack);
+            attacks[index] = attack;
+
+            subset = (subset - m.mask) & m.mask;
+        } while (subset != 0);
+
+        offset += 1U << (64 - m.shift);
+    }
+
+    assert(offset == TABLE_SIZE);
+}
+
+const MagicBitBoards::Tables MagicBitBoards::m_tables = MagicBitBoards::Tables();
+
+MagicBitBoards::Tables::Tables()
+    : usePext(BitOperations::detectCpuFeatures().fastPext) {
+    // Query the CPU directly. BitOperations' own detection result might not
+    // be initialized yet during static initialization.
+    initMagics(rook, rookAttacks, ROOK_MAGICS,
+               &MagicBitBoards::rookMask, &MagicBitBoards::slowRookAttacks, usePext);
+    initMagics(bishop, bishopAttacks, BISHOP_MAGICS,
+               &MagicBitBoards::bishopMask, &MagicBitBoards::slowBishopAttacks, usePext);
+}
+
+BitBoard MagicBitBoards::rookMask(Field field) {
+    return walkRay(field,  1,  0, 0, false) | walkRay(field, -1,  0, 0, false)
+         | walkRay(field,  0,  1, 0, false) | walkRay(field,  0, -1, 0, false);
+}
+
+BitBoard MagicBitBoards::bishopMask(Field field) {
+    return walkRay(field,  1,  1, 0, false) | walkRay(field, -1,  1, 0, false)
+         | walkRay(field,  1, -1, 0, false) | walkRay(field, -1, -1, 0, false);
+}
+
+BitBoard MagicBitBoards::slowRookAttacks(Field field, BitBoard allPieces) {
+    return walkRay(field,  1,  0, allPieces, true) | walkRay(field, -1,  0, allPieces, true)
+         | walkRay(field,  0,  1, allPieces, true) | walkRay(field,  0, -1, allPieces, true);
+}
+
+BitBoard MagicBitBoards::slowBishopAttacks(Field field, BitBoard allPieces) {
+    return walkRay(field,  1,  1, allPieces, true) | walkRay(field, -1,  1, allPieces, true)
+         | walkRay(field,  1, -1, allPieces, true) | walkRay(field, -1, -1, allPieces, true);
+}
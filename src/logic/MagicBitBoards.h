@@ -0,0 +1,138 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef MAGICBITBOARDS_H
+#define MAGICBITBOARDS_H
+
+#include <array>
+#include "logic/ChessTypes.h"
+#include "logic/BitOperations.h"
+
+/**
+ * @brief Magic bitboard attack lookup for the sliding pieces.
+ * The relevant occupancy on the rays of a rook or bishop is hashed with a
+ * precomputed "magic" multiplier into an index of a precomputed attack table,
+ * which turns slider turn generation into a constant time lookup.
+ * On CPUs with a fast BMI2 implementation the index is computed with PEXT
+ * instead, which needs no multiplication and addresses the same table layout.
+ * The magics are regenerated with the magicgen tool (test/other/magicgen.cpp).
+ * @see http://chessprogramming.wikispaces.com/Magic+Bitboards
+ */
+class MagicBitBoards {
+public:
+    //! Returns all fields attacked by a rook on the given field.
+    static BitBoard rookAttacks(Field field, BitBoard allPieces);
+    //! Returns all fields attacked by a bishop on the given field.
+    static BitBoard bishopAttacks(Field field, BitBoard allPieces);
+    //! Returns all fields attacked by a queen on the given field.
+    static BitBoard queenAttacks(Field field, BitBoard allPieces);
+
+    //! Relevant occupancy mask for a rook on the given field (rays without board edges).
+    static BitBoard rookMask(Field field);
+    //! Relevant occupancy mask for a bishop on the given field (rays without board edges).
+    static BitBoard bishopMask(Field field);
+
+    //! Calculates rook attacks by walking the rays. Only used for table setup.
+    static BitBoard slowRookAttacks(Field field, BitBoard allPieces);
+    //! Calculates bishop attacks by walking the rays. Only used for table setup.
+    static BitBoard slowBishopAttacks(Field field, BitBoard allPieces);
+
+    //! Number of attack table entries needed for fixed shift rook magics.
+    static const size_t ROOK_TABLE_SIZE = 102400;
+    //! Number of attack table entries needed for fixed shift bishop magics.
+    static const size_t BISHOP_TABLE_SIZE = 5248;
+
+    //! Returns true if the tables are indexed with PEXT instead of magics.
+    static bool usesPext();
+
+private:
+    //! Magic lookup parameters of a single field.
+    struct Magic {
+        BitBoard mask;
+        BitBoard magic;
+        unsigned int shift;
+        unsigned int offset;
+
+        /**
+         * @brief Returns the attack table index for the given board occupancy.
+         * usePext is the only dispatch, PEXT is executed unchecked.
+         */
+        inline size_t index(BitBoard allPieces, bool usePext) const {
+            if (usePext) {
+                return offset + static_cast<size_t>(BitOperations::extractBitsBMI2(allPieces, mask));
+            }
+            return offset + static_cast<size_t>(((allPieces & mask) * magic) >> shift);
+        }
+    };
+
+    class Tables {
+    public:
+        Tables();
+
+        //! Index with PEXT instead of the magic multiplication. Implies BMI2.
+        bool usePext;
+
+        std::array<Magic, NUM_FIELDS> rook;
+        std::array<Magic, NUM_FIELDS> bishop;
+
+        std::array<BitBoard, ROOK_TABLE_SIZE> rookAttacks;
+        std::array<BitBoard, BISHOP_TABLE_SIZE> bishopAttacks;
+    };
+
+    //! Fills the magic entries and the attack table for one piece type.
+    template <size_t TABLE_SIZE>
+    static void initMagics(std::array<Magic, NUM_FIELDS>& magics,
+                           std::array<BitBoard, TABLE_SIZE>& attacks,
+                           const std::array<BitBoard, NUM_FIELDS>& magicNumbers,
+                           BitBoard (*mask)(Field),
+                           BitBoard (*slowAttacks)(Field, BitBoard),
+                           bool usePext);
+
+    const static Tables m_tables;
+};
+
+inline BitBoard MagicBitBoards::rookAttacks(Field field, BitBoard allPieces) {
+    return m_tables.rookAttacks[m_tables.rook[field].index(allPieces, m_tables.usePext)];
+}
+
+inline BitBoard MagicBitBoards::bishopAttacks(Field field, BitBoard allPieces) {
+    return m_tables.bishopAttacks[m_tables.bishop[field].index(allPieces, m_tables.usePext)];
+}
+
+inline bool MagicBitBoards::usesPext() {
+    return m_tables.usePext;
+}
+
+inline BitBoard MagicBitBoards::queenAttacks(Field field, BitBoard allPieces) {
+    return rookAttacks(field, allPieces) | bishopAttacks(field, allPieces);
+}
+
+#endif // MAGICBITBOARDS_H
@@ -0,0 +1,117 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef MOVE_H
+#define MOVE_H
+
+#include <cstdint>
+#include <string>
+
+#include "Turn.h"
+
+class ChessBoard;
+
+/**
+ * @brief Compact 16 bit turn representation.
+ * Stores origin and target field as well as the action of a Turn. The moving
+ * piece is not stored, it is implied by the position the move is applied to.
+ * Used where many turns are kept around (e.g. the transposition table).
+ *
+ * Layout: bits 0-5 from, bits 6-11 to, bits 12-14 Turn::Action.
+ */
+class Move {
+public:
+    //! Creates the null move which does not represent any turn.
+    Move() : m_data(0) {}
+
+    Move(Field from, Field to, Turn::Action action = Turn::Move)
+        : m_data(static_cast<uint16_t>(
+              (from & FIELD_MASK)
+            | ((to & FIELD_MASK) << TO_SHIFT)
+            | (action << ACTION_SHIFT))) {}
+
+    //! Packs the given turn.
+    explicit Move(const Turn& turn)
+        : Move(turn.from, turn.to, turn.action) {}
+
+    Field getFrom() const { return static_cast<Field>(m_data & FIELD_MASK); }
+    Field getTo() const { return static_cast<Field>((m_data >> TO_SHIFT) & FIELD_MASK); }
+    Turn::Action getAction() const { return static_cast<Turn::Action>(m_data >> ACTION_SHIFT); }
+
+    //! Returns true for the null move.
+    bool isNull() const { return m_data == 0; }
+    //! Returns the raw encoding.
+    uint16_t getData() const { return m_data; }
+    //! Restores a move from its raw encoding (@see getData).
+    static Move fromData(uint16_t data) { Move move; move.m_data = data; return move; }
+
+    //! Returns true if the given turn packs to this move.
+    bool matches(const Turn& turn) const { return Move(turn) == *this; }
+    //! Same as operator==. Lets findTurn search move lists too.
+    bool matches(Move move) const { return move == *this; }
+
+    //! Returns true for promotions to any piece type.
+    bool isPromotion() const {
+        return getAction() >= Turn::PromotionQueen && getAction() <= Turn::PromotionRook;
+    }
+
+    //! Unpacks the move for the given moving piece.
+    Turn toTurn(Piece piece) const;
+    //! Unpacks the move taking the moving piece from the given board.
+    Turn toTurn(const ChessBoard& board) const;
+
+    bool operator==(const Move& other) const { return m_data == other.m_data; }
+    bool operator!=(const Move& other) const { return m_data != other.m_data; }
+
+    std::string toString() const;
+
+private:
+    static const uint16_t FIELD_MASK = 0x3F;
+    static const int TO_SHIFT = 6;
+    static const int ACTION_SHIFT = 12;
+
+    uint16_t m_data;
+};
+
+/**
+ * @brief Returns the turn in turns matching move.
+ * Turns may be given as Turn or as Move.
+ * @return Pointer into turns or nullptr if no turn matches.
+ */
+template <typename TTurnList>
+const typename TTurnList::value_type* findTurn(const TTurnList& turns, Move move) {
+    for (const auto& turn: turns) {
+        if (move.matches(turn)) return &turn;
+    }
+    return nullptr;
+}
+
+#endif // MOVE_H
@@ -0,0 +1,109 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef MOVELIST_H
+#define MOVELIST_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+#include "Move.h"
+
+/**
+ * @brief Fixed capacity container of packed turns without heap allocations.
+ * The storage lives inline in the object. Only the occupied part is
+ * copied. No chess position has more than 218 legal turns, so the
+ * capacity is never exceeded by the turn generation.
+ * @see Move
+ */
+class MoveList {
+public:
+    //! Maximum number of moves the list can hold.
+    static const size_t CAPACITY = 256;
+
+    using value_type = Move;
+    using iterator = Move*;
+    using const_iterator = const Move*;
+
+    static_assert(std::is_trivially_destructible<Move>::value,
+                  "Moves in the raw storage are never destroyed");
+
+    MoveList() : m_size(0) {}
+
+    MoveList(const MoveList& other) : m_size(0) {
+        *this = other;
+    }
+
+    MoveList& operator=(const MoveList& other) {
+        m_size = other.m_size;
+        std::copy(other.begin(), other.end(), begin());
+        return *this;
+    }
+
+    //! Appends a move. The list must not be full.
+    void push_back(Move move) {
+        assert(m_size < CAPACITY);
+        new (&m_storage[m_size]) Move(move);
+        ++m_size;
+    }
+
+    //! Removes all moves.
+    void clear() { m_size = 0; }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    Move& operator[](size_t i) {
+        assert(i < m_size);
+        return begin()[i];
+    }
+
+    const Move& operator[](size_t i) const {
+        assert(i < m_size);
+        return begin()[i];
+    }
+
+    iterator begin() { return reinterpret_cast<Move*>(&m_storage[0]); }
+    iterator end() { return begin() + m_size; }
+    const_iterator begin() const { return reinterpret_cast<const Move*>(&m_storage[0]); }
+    const_iterator end() const { return begin() + m_size; }
+
+private:
+    //! Raw storage, avoids default constructing CAPACITY moves.
+    typename std::aligned_storage<sizeof(Move), alignof(Move)>::type m_storage[CAPACITY];
+    //! Number of moves in the list.
+    size_t m_size;
+};
+
+#endif // MOVELIST_H
@@ -0,0 +1,87 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef PACKEDPOSITION_H
+#define PACKEDPOSITION_H
+
+#include <array>
+#include <cstring>
+#include <type_traits>
+#include "logic/ChessTypes.h"
+
+/**
+ * @brief Compact snapshot of a chess position.
+ * Holds no pointers and needs no heap, so it can be copied with memcpy
+ * into queues or written to files as is. Turn lists and game over flags
+ * aren't part of it, they are calculated when unpacking into a GameState.
+ * @see ChessBoard::toPackedPosition
+ * @see ChessBoard::fromPackedPosition
+ */
+struct PackedPosition {
+    //! Fields occupied by the pieces of each type, both players combined.
+    std::array<BitBoard, NUM_PIECETYPES> pieces;
+    //! Fields occupied by the pieces of each player.
+    std::array<BitBoard, NUM_PLAYERS> players;
+
+    uint16_t halfMoveClock;
+    uint16_t fullMoveClock;
+    //! PlayerColor of the player doing the next turn.
+    uint8_t nextPlayer;
+    //! Castling rights, see shortCastleBit and longCastleBit.
+    uint8_t castleRights;
+    //! Field with en passant rights. ERR if none.
+    uint8_t enPassantSquare;
+    //! Piece captured by the last turn, packed like the ChessBoard mailbox.
+    uint8_t lastCapturedPiece;
+
+    //! Returns the castleRights bit of the short castle right of player.
+    static uint8_t shortCastleBit(PlayerColor player) {
+        return static_cast<uint8_t>(1 << (2 * player));
+    }
+    //! Returns the castleRights bit of the long castle right of player.
+    static uint8_t longCastleBit(PlayerColor player) {
+        return static_cast<uint8_t>(2 << (2 * player));
+    }
+
+    bool operator==(const PackedPosition& other) const {
+        return std::memcmp(this, &other, sizeof(PackedPosition)) == 0;
+    }
+    bool operator!=(const PackedPosition& other) const {
+        return !(*this == other);
+    }
+};
+
+static_assert(std::is_trivially_copyable<PackedPosition>::value,
+              "PackedPosition has to stay memcpy-able");
+static_assert(sizeof(PackedPosition) <= 128,
+              "PackedPosition should fit into two cache lines");
+
+#endif // PACKEDPOSITION_H
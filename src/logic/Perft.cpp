@@ -0,0 +1,187 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <atomic>
+#include <sstream>
+#include <thread>
+
+#include "Perft.h"
+
+uint64_t Perft::perft(const GameState& state, int depth, PerftHashTable* table) {
+    GameState searchState(state);
+    return perftInPlace(searchState, depth, table);
+}
+
+uint64_t Perft::perftInPlace(GameState& state, int depth, PerftHashTable* table) {
+    if (depth <= 0) return 1;
+
+    // Generated turns are legal, no need to apply or even create them at the last ply
+    if (depth == 1) return state.countLegalMoves();
+
+    uint64_t nodes = 0;
+    if (table && table->lookup(state.getHash(), depth, nodes)) {
+        return nodes;
+    }
+
+    // Only generate once the table missed
+    const MoveList& moves = state.getMoveList();
+    for (const Move move: moves) {
+        state.makeTurn(move);
+        nodes += perftInPlace(state, depth - 1, table);
+        state.unmakeTurn();
+    }
+
+    if (table) table->store(state.getHash(), depth, nodes);
+
+    return nodes;
+}
+
+std::vector<Perft::DivideEntry> Perft::divide(const GameState& state,
+                                              int depth,
+                                              unsigned int threads,
+                                              PerftHashTable* table) {
+    struct Task {
+        size_t rootIndex;
+        GameState state;
+        int depth;
+        uint64_t nodes;
+    };
+
+    const std::vector<Turn> rootTurns = state.getTurnList();
+
+    // Split below the second ply on deep searches so the work can be
+    // spread evenly even if there are few root turns.
+    const bool splitSecondPly = threads > 1 && depth >= 4;
+
+    std::vector<Task> tasks;
+    for (size_t i = 0; i < rootTurns.size(); ++i) {
+        GameState newState(state);
+        newState.applyTurn(rootTurns[i]);
+
+        if (!splitSecondPly) {
+            tasks.push_back({i, newState, depth - 1, 0});
+            continue;
+        }
+
+        for (const Turn& turn: newState.getTurnList()) {
+            GameState splitState(newState);
+            splitState.applyTurn(turn);
+            tasks.push_back({i, splitState, depth - 2, 0});
+        }
+    }
+
+    // Each task is written by a single worker only so results need no locking
+    std::atomic<size_t> nextTask(0);
+    auto worker = [&]() {
+        for (size_t i = nextTask++; i < tasks.size(); i = nextTask++) {
+            Task& task = tasks[i];
+            task.nodes = perftInPlace(task.state, task.depth, table);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < threads; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread: workers) {
+        thread.join();
+    }
+
+    std::vector<DivideEntry> entries;
+    for (const Turn& turn: rootTurns) {
+        entries.push_back({turn, 0});
+    }
+    for (const Task& task: tasks) {
+        entries[task.rootIndex].nodes += task.nodes;
+    }
+
+    return entries;
+}
+
+uint64_t Perft::parallelPerft(const GameState& state,
+                              int depth,
+                              unsigned int threads,
+                              PerftHashTable* table) {
+    if (depth <= 0) return 1;
+
+    uint64_t nodes = 0;
+    for (const DivideEntry& entry: divide(state, depth, threads, table)) {
+        nodes += entry.nodes;
+    }
+
+    return nodes;
+}
+
+const std::vector<Perft::Position>& Perft::suite() {
+    static const std::vector<Position> positions = {
+        { "startpos",
+          "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+          { 20, 400, 8902, 197281, 4865609, 119060324 } },
+        { "kiwipete",
+          "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+          { 48, 2039, 97862, 4085603, 193690690 } },
+        // En passant, discovered checks along the rank
+        { "position3",
+          "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+          { 14, 191, 2812, 43238, 674624, 11030083 } },
+        // Promotions, castling rights lost by captures
+        { "position4",
+          "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+          { 6, 264, 9467, 422333, 15833292 } },
+        { "position4mirrored",
+          "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+          { 6, 264, 9467, 422333, 15833292 } },
+        { "position5",
+          "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+          { 44, 1486, 62379, 2103487, 89941194 } },
+        { "position6",
+          "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+          { 46, 2079, 89890, 3894594, 164075551 } }
+    };
+
+    return positions;
+}
+
+std::string Perft::toCoordinateNotation(const Turn& turn) {
+    std::stringstream ss;
+    ss << turn.from << turn.to;
+
+    switch (turn.action) {
+    case Turn::PromotionQueen:  ss << 'q'; break;
+    case Turn::PromotionBishop: ss << 'b'; break;
+    case Turn::PromotionKnight: ss << 'n'; break;
+    case Turn::PromotionRook:   ss << 'r'; break;
+    default: break;
+    }
+
+    return ss.str();
+}
@@ -0,0 +1,100 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef PERFT_H
+#define PERFT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "GameState.h"
+#include "PerftHashTable.h"
+
+/**
+ * @brief Performance test of the turn generation.
+ * Counts all leaf nodes of the game tree up to a fixed depth. The counts
+ * are well known for a set of standard positions which makes this the
+ * regression test for any change in turn generation.
+ * Deep counts are split over several threads which share a table of
+ * already counted subtrees.
+ * @see http://chessprogramming.wikispaces.com/Perft
+ */
+class Perft {
+public:
+    //! Position with its known node counts.
+    struct Position {
+        std::string name;
+        std::string fen;
+        //! Node counts for depth 1, 2, ...
+        std::vector<uint64_t> nodes;
+    };
+
+    //! Node count of a single root turn.
+    struct DivideEntry {
+        Turn turn;
+        uint64_t nodes;
+    };
+
+    //! Returns the number of leaf nodes depth plies below state.
+    static uint64_t perft(const GameState& state,
+                          int depth,
+                          PerftHashTable* table = nullptr);
+    /**
+     * @brief Returns the perft count for every root turn of state.
+     * @param depth Depth including the root turn. Must be >= 1.
+     * @param threads Number of worker threads.
+     * @param table Optional table shared by all workers.
+     */
+    static std::vector<DivideEntry> divide(const GameState& state,
+                                           int depth,
+                                           unsigned int threads = 1,
+                                           PerftHashTable* table = nullptr);
+    //! Multi-threaded perft, sum of divide.
+    static uint64_t parallelPerft(const GameState& state,
+                                  int depth,
+                                  unsigned int threads,
+                                  PerftHashTable* table = nullptr);
+
+    //! Returns the standard positions with reference node counts.
+    static const std::vector<Position>& suite();
+
+    //! Returns the turn in coordinate notation (e.g. e2e4, e7e8q).
+    static std::string toCoordinateNotation(const Turn& turn);
+
+private:
+    //! Perft on state using make/unmake. state is unchanged on return.
+    static uint64_t perftInPlace(GameState& state,
+                                 int depth,
+                                 PerftHashTable* table);
+};
+
+#endif // PERFT_H
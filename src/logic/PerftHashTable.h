@@ -0,0 +1,127 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef PERFTHASHTABLE_H
+#define PERFTHASHTABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "ChessTypes.h"
+
+/**
+ * @brief Lock-free table caching perft node counts of subtrees.
+ * Maps (zobrist hash, depth) to the number of leaf nodes below the
+ * position and is meant to be shared by all perft worker threads.
+ * Every entry is stored as two words where the first one is the hash
+ * xor'ed with the second one. A torn write of concurrent stores thus
+ * fails verification on lookup and is treated as a miss instead of
+ * returning a wrong count. Entries are always replaced.
+ * @see http://chessprogramming.wikispaces.com/Shared+Hash+Table#Lockless
+ */
+class PerftHashTable {
+public:
+    /**
+     * @brief Creates an empty table.
+     * @param tablesize Maximum number of entries, rounded down to a power of two.
+     */
+    explicit PerftHashTable(size_t tablesize = 1 << 20)
+        : m_table(roundDownToPowerOfTwo(tablesize))
+        , m_mask(m_table.size() - 1) {
+        clear();
+    }
+
+    //! Stores the node count of the position with the given hash at depth.
+    void store(Hash hash, int depth, uint64_t nodes) {
+        const uint64_t data = (nodes << DEPTH_BITS) | static_cast<uint64_t>(depth);
+        Entry& entry = m_table[hash & m_mask];
+
+        entry.key.store(hash ^ data, std::memory_order_relaxed);
+        entry.data.store(data, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Lookup the node count of the given position at depth.
+     * @param nodesOut Set to the stored node count on hit.
+     * @return True on hit.
+     * @note Not secure against zobrist hash collisions.
+     */
+    bool lookup(Hash hash, int depth, uint64_t& nodesOut) const {
+        const Entry& entry = m_table[hash & m_mask];
+
+        const uint64_t data = entry.data.load(std::memory_order_relaxed);
+        const uint64_t key = entry.key.load(std::memory_order_relaxed);
+
+        if ((key ^ data) != hash
+                || (data & DEPTH_MASK) != static_cast<uint64_t>(depth)) {
+            return false;
+        }
+
+        nodesOut = data >> DEPTH_BITS;
+        return true;
+    }
+
+    //! Removes all entries. Must not be called concurrently.
+    void clear() {
+        for (Entry& entry: m_table) {
+            // Perft never looks up depth 0 so this is never a hit
+            entry.key.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    //! Returns the number of entries in the table.
+    size_t getTableSize() const {
+        return m_table.size();
+    }
+
+private:
+    //! Lower bits of the data word holding the depth.
+    static const int DEPTH_BITS = 8;
+    static const uint64_t DEPTH_MASK = (1 << DEPTH_BITS) - 1;
+
+    struct Entry {
+        std::atomic<uint64_t> key;  //!< Hash xor data
+        std::atomic<uint64_t> data; //!< Node count << DEPTH_BITS | depth
+    };
+
+    static size_t roundDownToPowerOfTwo(size_t size) {
+        size_t result = 1;
+        while (result * 2 <= size) result *= 2;
+        return result;
+    }
+
+    std::vector<Entry> m_table;
+    const size_t m_mask;
+};
+
+#endif // PERFTHASHTABLE_H
@@ -0,0 +1,146 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "PositionLoader.h"
+#include "FenParser.h"
+
+double PositionLoader::Result::positionsPerSecond() const {
+    const double seconds = std::chrono::duration<double>(duration).count();
+    return seconds > 0 ? positions.size() / seconds : 0;
+}
+
+double PositionLoader::Result::megabytesPerSecond() const {
+    const double seconds = std::chrono::duration<double>(duration).count();
+    return seconds > 0 ? bytes / (1024.0 * 1024.0) / seconds : 0;
+}
+
+std::string PositionLoader::Result::toString() const {
+    std::stringstream ss;
+    ss << "Loaded " << positions.size() << " positions from " << lines << " lines"
+       << " (" << errors << " errors) in "
+       << std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() << "ms: "
+       << static_cast<uint64_t>(positionsPerSecond()) << " positions/s, "
+       << megabytesPerSecond() << " MB/s";
+    return ss.str();
+}
+
+PositionLoader::Result PositionLoader::loadFile(const std::string& path, unsigned int threads) {
+    using namespace boost::interprocess;
+
+    // Empty files can't be mapped
+    if (boost::filesystem::file_size(path) == 0) {
+        return Result();
+    }
+
+    file_mapping file(path.c_str(), read_only);
+    mapped_region region(file, read_only);
+    region.advise(mapped_region::advice_sequential);
+
+    const char* begin = static_cast<const char*>(region.get_address());
+    return loadBuffer(begin, begin + region.get_size(), threads);
+}
+
+PositionLoader::Result PositionLoader::loadBuffer(const char* begin,
+                                                  const char* end,
+                                                  unsigned int threads) {
+    const auto start = std::chrono::steady_clock::now();
+    threads = std::max(threads, 1u);
+
+    // Split into chunks of about equal size which end after a line break
+    const size_t chunkSize = (end - begin) / threads + 1;
+    std::vector<const char*> bounds = { begin };
+    for (unsigned int i = 1; i < threads; ++i) {
+        const char* bound = std::max(bounds.back(), std::min(begin + i * chunkSize, end));
+        bound = std::find(bound, end, '\n');
+        bounds.push_back(bound == end ? end : bound + 1);
+    }
+    bounds.push_back(end);
+
+    std::vector<Result> results(threads);
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < threads; ++i) {
+        workers.emplace_back(&PositionLoader::parseChunk, bounds[i], bounds[i + 1], std::ref(results[i]));
+    }
+    parseChunk(bounds[0], bounds[1], results[0]);
+    for (std::thread& worker: workers) {
+        worker.join();
+    }
+
+    Result result;
+    size_t numPositions = 0;
+    for (const Result& chunk: results) {
+        numPositions += chunk.positions.size();
+    }
+    result.positions.reserve(numPositions);
+    for (const Result& chunk: results) {
+        result.positions.insert(result.positions.end(), chunk.positions.begin(), chunk.positions.end());
+        result.lines += chunk.lines;
+        result.errors += chunk.errors;
+    }
+    result.bytes = end - begin;
+    result.duration = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start);
+
+    return result;
+}
+
+void PositionLoader::parseChunk(const char* begin, const char* end, Result& result) {
+    // FEN lines are about 60 bytes long
+    result.positions.reserve((end - begin) / 48);
+
+    PackedPosition position;
+    for (const char* line = begin; line < end; ) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(line, '\n', end - line));
+        if (!lineEnd) lineEnd = end;
+        const char* next = (lineEnd == end) ? end : lineEnd + 1;
+
+        if (lineEnd != line && lineEnd[-1] == '\r') --lineEnd;
+
+        if (lineEnd != line && *line != '#') {
+            ++result.lines;
+            if (FenParser::parse(line, lineEnd, position)) {
+                result.positions.push_back(position);
+            } else {
+                ++result.errors;
+            }
+        }
+
+        line = next;
+    }
+}
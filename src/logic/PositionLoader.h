@@ -0,0 +1,85 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef POSITIONLOADER_H
+#define POSITIONLOADER_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "logic/PackedPosition.h"
+
+/**
+ * @brief Bulk loader for files with one FEN or EPD position per line.
+ * The file is memory mapped and split into chunks at line boundaries
+ * which are parsed with FenParser on separate threads. Empty lines and
+ * lines starting with '#' are skipped.
+ */
+class PositionLoader {
+public:
+    //! Loaded positions and parse statistics.
+    struct Result {
+        Result() : lines(0), errors(0), bytes(0), duration() {}
+
+        //! Parsed positions in the order of the input.
+        std::vector<PackedPosition> positions;
+        //! Number of non-empty, non-comment lines.
+        size_t lines;
+        //! Number of lines which couldn't be parsed.
+        size_t errors;
+        //! Size of the input.
+        size_t bytes;
+        //! Time taken for loading and parsing.
+        std::chrono::microseconds duration;
+
+        //! Parse throughput in positions per second.
+        double positionsPerSecond() const;
+        //! Parse throughput in megabytes per second.
+        double megabytesPerSecond() const;
+        std::string toString() const;
+    };
+
+    /**
+     * @brief Loads all positions from the given file.
+     * @param threads Number of threads to parse with.
+     * @throw boost::interprocess::interprocess_exception If the file can't be mapped.
+     */
+    static Result loadFile(const std::string& path, unsigned int threads);
+    //! Loads all positions from the given buffer.
+    static Result loadBuffer(const char* begin, const char* end, unsigned int threads);
+
+private:
+    //! Parses all lines in [begin, end) into result.
+    static void parseChunk(const char* begin, const char* end, Result& result);
+};
+
+#endif // POSITIONLOADER_H
@@ -30,38 +30,179 @@
     POSSIBILITY OF SUCH DAMAGE.
 */
 #include "TurnGenerator.h"
+#include "MagicBitBoards.h"
+#include "AttackTables.h"
 
 void TurnGenerator::initFlags(ChessBoard &cb) {
-    BitBoard bbAllOppTurns = calcAllOppTurns(Black, cb);
-    BitBoard bbKingInCheck = cb.m_bb[White][King] & bbAllOppTurns;
+    BitBoard bbKingInCheck = cb.m_bb[White][King] & cb.getAttacks(Black);
 
     if (bbKingInCheck == cb.m_bb[White][King]) {
         cb.setKingInCheck(White, true);
     }
 
-    bbAllOppTurns = calcAllOppTurns(White, cb);
-    bbKingInCheck = cb.m_bb[Black][King] & bbAllOppTurns;
+    bbKingInCheck = cb.m_bb[Black][King] & cb.getAttacks(White);
 
     if (bbKingInCheck == cb.m_bb[Black][King]) {
         cb.setKingInCheck(Black, true);
     }
 }
 
-std::vector<Turn> TurnGenerator::getTurnList() const {
-    return turnList;
+const MoveList& TurnGenerator::getMoveList() const {
+    return moveList;
 }
 
-void TurnGenerator::generateTurns(PlayerColor player, ChessBoard &cb) {
-    PlayerColor opp = togglePlayerColor(player);
-    Field curPiecePos;
-    Piece piece;
+namespace {
+    //! Collects the visited turns in a move list.
+    struct MoveListSink {
+        MoveListSink(const TurnGenerator& turnGen, MoveList& moves)
+            : turnGen(turnGen), moves(moves) {}
 
-    BitBoard bbCurPieceType, bbCurPiece, bbTurns;
-    BitBoard bbAllPieces   = cb.m_bb[White][AllPieces] | cb.m_bb[Black][AllPieces];
-    BitBoard bbAllOppTurns = calcAllOppTurns(opp, cb);
-    BitBoard bbKingInCheck = cb.m_bb[player][King] & bbAllOppTurns;
+        bool operator()(Piece piece, Field from, BitBoard bbTurns) {
+            turnGen.bitBoardToMoves(piece, from, bbTurns, moves);
+            return true;
+        }
+        bool castle(const Turn& turn) {
+            moves.push_back(Move(turn));
+            return true;
+        }
+
+        const TurnGenerator& turnGen;
+        MoveList& moves;
+    };
+
+    //! Stops at the first visited turn.
+    struct AnyTurnSink {
+        AnyTurnSink() : found(false) {}
+
+        bool operator()(Piece, Field, BitBoard bbTurns) {
+            found = (bbTurns != 0);
+            return !found;
+        }
+        bool castle(const Turn&) {
+            found = true;
+            return false;
+        }
+
+        bool found;
+    };
+
+    //! Counts the visited turns, a promotion counts once per piece type.
+    struct CountTurnSink {
+        CountTurnSink() : count(0) {}
+
+        bool operator()(Piece piece, Field, BitBoard bbTurns) {
+            if (piece.type == Pawn) {
+                const BitBoard bbPromotions = bbTurns & 0xFF000000000000FFULL;
+                count += 4 * BitOperations::popCount(bbPromotions);
+                bbTurns &= ~bbPromotions;
+            }
+            count += BitOperations::popCount(bbTurns);
+            return true;
+        }
+        bool castle(const Turn&) {
+            ++count;
+            return true;
+        }
+
+        size_t count;
+    };
+
+    //! Collects captures and queen promotions only.
+    struct CaptureListSink {
+        CaptureListSink(const TurnGenerator& turnGen,
+                        BitBoard bbVictims,
+                        BitBoard bbEnPassant,
+                        MoveList& moves)
+            : turnGen(turnGen), bbVictims(bbVictims)
+            , bbEnPassant(bbEnPassant), moves(moves) {}
+
+        bool operator()(Piece piece, Field from, BitBoard bbTurns) {
+            if (piece.type == Pawn) {
+                BitBoard bbPromotions = bbTurns & 0xFF000000000000FFULL;
+                bbTurns &= ~bbPromotions;
+                while (bbPromotions != 0) {
+                    const Field to = BB_SCAN(bbPromotions);
+                    BIT_CLEAR(bbPromotions, to);
+                    moves.push_back(Move(from, to, Turn::PromotionQueen));
+                }
+                bbTurns &= bbVictims | bbEnPassant;
+            } else {
+                bbTurns &= bbVictims;
+            }
+            turnGen.bitBoardToMoves(piece, from, bbTurns, moves);
+            return true;
+        }
+        bool castle(const Turn&) {
+            return true;
+        }
+
+        const TurnGenerator& turnGen;
+        const BitBoard bbVictims;
+        const BitBoard bbEnPassant;
+        MoveList& moves;
+    };
+
+    //! Collects the turns CaptureListSink leaves out.
+    struct QuietListSink {
+        QuietListSink(const TurnGenerator& turnGen,
+                      BitBoard bbVictims,
+                      BitBoard bbEnPassant,
+                      MoveList& moves)
+            : turnGen(turnGen), bbVictims(bbVictims)
+            , bbEnPassant(bbEnPassant), moves(moves) {}
+
+        bool operator()(Piece piece, Field from, BitBoard bbTurns) {
+            if (piece.type == Pawn) {
+                BitBoard bbPromotions = bbTurns & 0xFF000000000000FFULL;
+                bbTurns &= ~bbPromotions;
+                while (bbPromotions != 0) {
+                    const Field to = BB_SCAN(bbPromotions);
+                    BIT_CLEAR(bbPromotions, to);
+                    moves.push_back(Move(from, to, Turn::PromotionBishop));
+                    moves.push_back(Move(from, to, Turn::PromotionRook));
+                    moves.push_back(Move(from, to, Turn::PromotionKnight));
+                }
+                bbTurns &= ~(bbVictims | bbEnPassant);
+            } else {
+                bbTurns &= ~bbVictims;
+            }
+            turnGen.bitBoardToMoves(piece, from, bbTurns, moves);
+            return true;
+        }
+        bool castle(const Turn& turn) {
+            moves.push_back(Move(turn));
+            return true;
+        }
+
+        const TurnGenerator& turnGen;
+        const BitBoard bbVictims;
+        const BitBoard bbEnPassant;
+        MoveList& moves;
+    };
+
+    //! Collects the target fields of the turns from a single field.
+    struct FromFieldSink {
+        explicit FromFieldSink(Field from) : from(from), bbTurns(0) {}
 
-    turnList.clear();
+        bool operator()(Piece, Field pieceFrom, BitBoard bbPieceTurns) {
+            if (pieceFrom == from) {
+                bbTurns |= bbPieceTurns;
+            }
+            return true;
+        }
+        bool castle(const Turn&) {
+            return true;
+        }
+
+        const Field from;
+        BitBoard bbTurns;
+    };
+}
+
+void TurnGenerator::generateTurns(PlayerColor player, ChessBoard &cb) {
+    const PlayerColor opp = togglePlayerColor(player);
+
+    moveList.clear();
 
     /* Der gegnerische King kann in keinem (korrekten) Fall im Schach stehen
        wenn man selbst an der Reihe ist, da sonst das Spiel beendet waere,
@@ -72,9 +213,7 @@ void TurnGenerator::generateTurns(PlayerColor player, ChessBoard &cb) {
            im Schach? -> Kann nur der Fall sein, wenn der GameState aus einem
            ungueltigen (bereits "beendetem") Chessboard geladen wurde, daher
            Spiel beenden und Zuggeneration abbrechen. */
-        BitBoard bb = calcAllOppTurns(player, cb);
-        BitBoard bb2 = cb.m_bb[opp][King] & bb;
-        if (bb2 == cb.m_bb[opp][King]) {
+        if (isOppKingAttacked(opp, cb)) {
             cb.setCheckmate(opp);
             return;
         }
@@ -82,287 +221,486 @@ void TurnGenerator::generateTurns(PlayerColor player, ChessBoard &cb) {
         cb.setKingInCheck(opp, false);
     }
 
-    if (bbKingInCheck == cb.m_bb[player][King]) {
-        /* Wenn der King im Schach steht, dann nur Zuege berechnen um das
-         * Schachgebot aufzuheben. Wenn keine Zuege gefunden -> Schachmatt */
-        cb.setKingInCheck(player, true);
-
-        /* Um die legalen Zuege der Figuren (ausgenommen King) herauszufinden:
-           Welche gegnerische Figur setzt den King ins Schach?
-           -> Diese Figur entweder schlagen oder den Weg abschneiden
-           -> Von dieser Figur wird daher die Position benoetigt und (bei einem
-              sliding piece) die Turns, die ihm zum King fuehren (der "Weg") */
-        BitBoard bbUnCheckFields = calcUnCheckFields(opp, cb);
-
-        /* Zunaechst normale Zugberechnung
-           ABER: Turns anschließend mit bbUnCheckFields verunden */
-        for (int pieceType = King; pieceType <= Pawn ; pieceType++) {
-            piece.type   = (PieceType) pieceType;
-            piece.player = player;
-
-            bbCurPieceType = cb.m_bb[player][pieceType];
-            while (bbCurPieceType != 0) {
-                bbCurPiece  = 0;
-                curPiecePos = BB_SCAN(bbCurPieceType);
-                BIT_CLEAR(bbCurPieceType, curPiecePos);
-                BIT_SET  (bbCurPiece,     curPiecePos);
-                bbTurns = calcMoveTurns(piece, bbCurPiece, bbAllOppTurns, cb);
-
-                if (pieceType != King) {
-                    bbTurns &= bbUnCheckFields;
-                }
+    MoveListSink sink(*this, moveList);
+    const bool kingInCheck = visitLegalTurns(player, cb, sink);
+    cb.setKingInCheck(player, kingInCheck);
 
-                bitBoardToTurns(
-                    piece, (Field) curPiecePos,
-                    bbTurns, bbAllOppTurns, cb,
-                    turnList);
-            }
+    if (moveList.empty()) {
+        if (kingInCheck) {
+            cb.setCheckmate(player);
+        } else {
+            cb.setStalemate();
+        }
+    }
+
+    //turnList.push_back(Turn::Forfeit);
+}
+
+void TurnGenerator::updateFlags(PlayerColor player, ChessBoard &cb) const {
+    const PlayerColor opp = togglePlayerColor(player);
+
+    // Wie in generateTurns, nur ohne Zugliste
+    if (cb.getKingInCheck()[opp]) {
+        if (isOppKingAttacked(opp, cb)) {
+            cb.setCheckmate(opp);
+            return;
         }
+        cb.setKingInCheck(opp, false);
+    }
+
+    AnyTurnSink sink;
+    const bool kingInCheck = visitLegalTurns(player, cb, sink);
+    cb.setKingInCheck(player, kingInCheck);
 
-        if (turnList.empty()) {
+    if (!sink.found) {
+        if (kingInCheck) {
             cb.setCheckmate(player);
+        } else {
+            cb.setStalemate();
+        }
+    }
+}
+
+bool TurnGenerator::hasAnyLegalMove(PlayerColor player, const ChessBoard &cb) const {
+    const PlayerColor opp = togglePlayerColor(player);
+    if (cb.getKingInCheck()[opp] && isOppKingAttacked(opp, cb)) {
+        return false;
+    }
+
+    AnyTurnSink sink;
+    visitLegalTurns(player, cb, sink);
+    return sink.found;
+}
+
+size_t TurnGenerator::countLegalMoves(PlayerColor player, const ChessBoard &cb) const {
+    const PlayerColor opp = togglePlayerColor(player);
+    if (cb.getKingInCheck()[opp] && isOppKingAttacked(opp, cb)) {
+        return 0;
+    }
+
+    CountTurnSink sink;
+    visitLegalTurns(player, cb, sink);
+    return sink.count;
+}
+
+void TurnGenerator::generateCaptures(PlayerColor player,
+                                     const ChessBoard &cb,
+                                     MoveList& movesOut) const {
+    const PlayerColor opp = togglePlayerColor(player);
+    if (cb.getKingInCheck()[opp] && isOppKingAttacked(opp, cb)) {
+        return;
+    }
+
+    BitBoard bbEnPassant = 0;
+    if (cb.getEnPassantSquare() != ERR) {
+        BIT_SET(bbEnPassant, cb.getEnPassantSquare());
+    }
+
+    CaptureListSink sink(*this, cb.m_bb[opp][AllPieces], bbEnPassant, movesOut);
+    visitLegalTurns(player, cb, sink);
+}
+
+void TurnGenerator::generateQuiets(PlayerColor player,
+                                   const ChessBoard &cb,
+                                   MoveList& movesOut) const {
+    const PlayerColor opp = togglePlayerColor(player);
+    if (cb.getKingInCheck()[opp] && isOppKingAttacked(opp, cb)) {
+        return;
+    }
+
+    BitBoard bbEnPassant = 0;
+    if (cb.getEnPassantSquare() != ERR) {
+        BIT_SET(bbEnPassant, cb.getEnPassantSquare());
+    }
+
+    QuietListSink sink(*this, cb.m_bb[opp][AllPieces], bbEnPassant, movesOut);
+    visitLegalTurns(player, cb, sink);
+}
+
+bool TurnGenerator::isLegalMove(PlayerColor player,
+                                const ChessBoard &cb,
+                                Move move) const {
+    const PlayerColor opp = togglePlayerColor(player);
+    if (cb.getKingInCheck()[opp] && isOppKingAttacked(opp, cb)) {
+        return false;
+    }
+
+    const Field from = move.getFrom();
+    const Field to = move.getTo();
+    const Piece piece = cb.getPieceAt(from);
+    if (piece.type == NoType || piece.player != player) {
+        return false;
+    }
+
+    const BitBoard bbAllOppTurns = cb.getAttacks(opp);
+    const bool kingInCheck = (cb.m_bb[player][King] & bbAllOppTurns) != 0;
+
+    if (move.getAction() == Turn::Castle) {
+        // Nur die Rochaden, die auch visitLegalTurns erzeugen wuerde
+        const Field kingPos = (player == White) ? E1 : E8;
+        if (piece.type != King || from != kingPos || kingInCheck) {
+            return false;
+        }
+
+        const BitBoard bbAllPieces = cb.m_bb[White][AllPieces] | cb.m_bb[Black][AllPieces];
+        if (to == ((player == White) ? G1 : G8)) {
+            return cb.m_shortCastleRight[player] &&
+                   calcShortCastleTurns(player, bbAllPieces, bbAllOppTurns) != 0;
         }
+        if (to == ((player == White) ? C1 : C8)) {
+            return cb.m_longCastleRight[player] &&
+                   calcLongCastleTurns(player, bbAllPieces, bbAllOppTurns) != 0;
+        }
+        return false;
+    }
+
+    // Ein Pawn auf der letzten Reihe muss umgewandelt werden, sonst nichts
+    const bool promotion = piece.type == Pawn && (rankFor(to) == Eight || rankFor(to) == One);
+    if (promotion ? !move.isPromotion() : move.getAction() != Turn::Move) {
+        return false;
+    }
 
+    BitBoard bbTurns;
+    if (kingInCheck) {
+        /* Im Schach gelten die Regeln aus visitEvasions. Das kommt selten
+           vor, daher einfach alle Zuege besuchen und die der Figur merken. */
+        FromFieldSink sink(from);
+        visitLegalTurns(player, cb, sink);
+        bbTurns = sink.bbTurns;
     } else {
-        /* Normale Zugberechnung durchfuehren; werden keine Zuege gefunden
-           liegt eine Pattstellung vor */
-        cb.setKingInCheck(player, false);
-
-        // short castle turns
-        if (cb.m_shortCastleRight[player]) {
-            BitBoard bbShortCastleKingTurn = calcShortCastleTurns(player,
-                                                                  bbAllPieces,
-                                                                  bbAllOppTurns);
-            if (bbShortCastleKingTurn != 0) {
-                if (player == White) {
-                    turnList.push_back(Turn::castle(Piece(White, King), E1, G1));
-                } else {
-                    turnList.push_back(Turn::castle(Piece(Black, King), E8, G8));
-                }
-            }
+        std::array<BitBoard, NUM_FIELDS> pinRays;
+        const BitBoard bbPinned = calcPinnedPieces(player, cb, pinRays);
+        bbTurns = calcLegalTurnsFrom(piece, from, bbAllOppTurns, bbPinned, pinRays, cb);
+    }
+
+    return BIT_ISSET(bbTurns, to);
+}
+
+bool TurnGenerator::isOppKingAttacked(PlayerColor opp, const ChessBoard& cb) const {
+    const BitBoard bbKing = cb.m_bb[opp][King] & cb.getAttacks(togglePlayerColor(opp));
+    return bbKing == cb.m_bb[opp][King];
+}
+
+inline BitBoard TurnGenerator::calcLegalTurnsFrom(Piece piece,
+                                                  Field from,
+                                                  BitBoard bbAllOppTurns,
+                                                  BitBoard bbPinned,
+                                                  const std::array<BitBoard, NUM_FIELDS>& pinRays,
+                                                  const ChessBoard& cb) const {
+    BitBoard bbTurns;
+    if (piece.type == Pawn) {
+        bbTurns = calcMoveTurns(piece, (BitBoard)1 << from, bbAllOppTurns, cb);
+    } else {
+        /* Fuer alle anderen Figuren entsprechen die Zuege den vom
+           ChessBoard gepflegten Angriffen */
+        bbTurns = cb.getAttacksFrom(from) & ~cb.m_bb[piece.player][AllPieces];
+        if (piece.type == King) {
+            bbTurns &= ~bbAllOppTurns;
         }
+    }
 
-        // long castle turns
-        if (cb.m_longCastleRight[player]) {
-            BitBoard bbLongCastleKingTurn = calcLongCastleTurns(player,
-                                                                bbAllPieces,
-                                                                bbAllOppTurns);
-            if (bbLongCastleKingTurn != 0) {
-                if (player == White) {
-                    turnList.push_back(Turn::castle(Piece(White, King), E1, C1));
-                } else {
-                    turnList.push_back(Turn::castle(Piece(Black, King), E8, C8));
-                }
-            }
+    if (BIT_ISSET(bbPinned, from)) {
+        bbTurns &= pinRays[from];
+    }
+
+    if (piece.type == Pawn &&
+            cb.m_enPassantSquare != ERR &&
+            BIT_ISSET(bbTurns, cb.m_enPassantSquare) &&
+            !isEnPassantLegal(piece.player, from, cb)) {
+        BIT_CLEAR(bbTurns, cb.m_enPassantSquare);
+    }
+
+    return bbTurns;
+}
+
+template <class TurnSink>
+bool TurnGenerator::visitLegalTurns(PlayerColor player,
+                                    const ChessBoard& cb,
+                                    TurnSink& sink) const {
+    PlayerColor opp = togglePlayerColor(player);
+    Field curPiecePos;
+    Piece piece;
+
+    BitBoard bbCurPieceType, bbTurns;
+    BitBoard bbAllPieces   = cb.m_bb[White][AllPieces] | cb.m_bb[Black][AllPieces];
+    // Die Angriffe werden vom ChessBoard inkrementell gepflegt
+    const BitBoard bbAllOppTurns = cb.getAttacks(opp);
+
+    /* Gefesselte Figuren werden einmal pro Stellung berechnet. Eine
+       gefesselte Figur darf nur auf dem Strahl zwischen King und
+       fesselnder Figur ziehen. */
+    std::array<BitBoard, NUM_FIELDS> pinRays;
+    const BitBoard bbPinned = calcPinnedPieces(player, cb, pinRays);
+
+    /* Alle gegnerischen Figuren, die den King ins Schach setzen */
+    BitBoard bbCheckers = 0;
+    if ((cb.m_bb[player][King] & bbAllOppTurns) != 0) {
+        bbCheckers = calcAttackersTo(BB_SCAN(cb.m_bb[player][King]), opp, bbAllPieces, cb);
+    }
+
+    if (bbCheckers != 0) {
+        /* Wenn der King im Schach steht, dann nur Zuege berechnen um das
+         * Schachgebot aufzuheben. Wenn keine Zuege gefunden -> Schachmatt */
+        visitEvasions(player, bbCheckers, bbPinned, cb, sink);
+        return true;
+    }
+
+    /* Normale Zugberechnung durchfuehren; werden keine Zuege gefunden
+       liegt eine Pattstellung vor */
+
+    // short castle turns
+    if (cb.m_shortCastleRight[player]) {
+        BitBoard bbShortCastleKingTurn = calcShortCastleTurns(player,
+                                                              bbAllPieces,
+                                                              bbAllOppTurns);
+        if (bbShortCastleKingTurn != 0) {
+            const bool goOn = (player == White)
+                ? sink.castle(Turn::castle(Piece(White, King), E1, G1))
+                : sink.castle(Turn::castle(Piece(Black, King), E8, G8));
+            if (!goOn) return false;
         }
+    }
 
-        // move turns
-        for (int pieceType = King; pieceType <= Pawn ; pieceType++) {
-            piece.type   = (PieceType) pieceType;
-            piece.player = player;
-
-            bbCurPieceType = cb.m_bb[player][pieceType];
-            while (bbCurPieceType != 0) {
-                bbCurPiece  = 0;
-                curPiecePos = BB_SCAN(bbCurPieceType);
-                BIT_CLEAR(bbCurPieceType, curPiecePos);
-                BIT_SET  (bbCurPiece,     curPiecePos);
-                bbTurns     = calcMoveTurns(piece, bbCurPiece, bbAllOppTurns, cb);
-
-                bitBoardToTurns(piece, (Field) curPiecePos,
-                                bbTurns, bbAllOppTurns, cb,
-                                turnList);
-            }
+    // long castle turns
+    if (cb.m_longCastleRight[player]) {
+        BitBoard bbLongCastleKingTurn = calcLongCastleTurns(player,
+                                                            bbAllPieces,
+                                                            bbAllOppTurns);
+        if (bbLongCastleKingTurn != 0) {
+            const bool goOn = (player == White)
+                ? sink.castle(Turn::castle(Piece(White, King), E1, C1))
+                : sink.castle(Turn::castle(Piece(Black, King), E8, C8));
+            if (!goOn) return false;
         }
+    }
 
-        if (turnList.empty()) {
-            cb.setStalemate();
+    // move turns
+    for (int pieceType = King; pieceType <= Pawn ; pieceType++) {
+        piece.type   = (PieceType) pieceType;
+        piece.player = player;
+
+        bbCurPieceType = cb.m_bb[player][pieceType];
+        while (bbCurPieceType != 0) {
+            curPiecePos = BB_SCAN(bbCurPieceType);
+            BIT_CLEAR(bbCurPieceType, curPiecePos);
+            bbTurns = calcLegalTurnsFrom(piece, curPiecePos, bbAllOppTurns,
+                                         bbPinned, pinRays, cb);
+
+            if (!sink(piece, curPiecePos, bbTurns)) return false;
         }
     }
 
-    //turnList.push_back(Turn::Forfeit);
+    return false;
 }
 
-void TurnGenerator::bitBoardToTurns(Piece piece,
-                                    Field from,
-                                    BitBoard bbTurns,
-                                    BitBoard bbAllOppTurns,
-                                    ChessBoard& cb,
-                                    Turns& turnsOut) {
-    Field to;
+template <class TurnSink>
+void TurnGenerator::visitEvasions(PlayerColor player,
+                                  BitBoard bbCheckers,
+                                  BitBoard bbPinned,
+                                  const ChessBoard& cb,
+                                  TurnSink& sink) const {
+    const PlayerColor opp = togglePlayerColor(player);
+    const Field kingPos = BB_SCAN(cb.m_bb[player][King]);
+    const BitBoard bbOwnPieces = cb.m_bb[player][AllPieces];
+
+    /* Der King darf weder auf angegriffene Felder ziehen, noch auf dem
+       Strahl eines schachgebenden sliding pieces zurueckweichen. Die
+       schachgebende Figur selbst darf er schlagen, sofern sie nicht
+       gedeckt ist. */
+    BitBoard bbKingForbidden = cb.getAttacks(opp);
+    BitBoard bbSliders = bbCheckers & ~(cb.m_bb[opp][Pawn] | cb.m_bb[opp][Knight]);
+    while (bbSliders != 0) {
+        const Field sliderPos = BB_SCAN(bbSliders);
+        BIT_CLEAR(bbSliders, sliderPos);
+
+        bbKingForbidden |= AttackTables::line(sliderPos, kingPos) & ~((BitBoard)1 << sliderPos);
+    }
 
-    while (bbTurns != 0) {
-        to = BB_SCAN(bbTurns);
-        BIT_CLEAR(bbTurns, to);
+    if (!sink(Piece(player, King),
+              kingPos,
+              cb.getAttacksFrom(kingPos) & ~bbOwnPieces & ~bbKingForbidden)) {
+        return;
+    }
+
+    // Doppelschach: Nur der King darf ziehen
+    if ((bbCheckers & (bbCheckers - 1)) != 0) {
+        return;
+    }
+
+    /* Einfaches Schach: Die schachgebende Figur schlagen oder den Weg
+       zum King verstellen. Gefesselte Figuren koennen beides nicht. */
+    const Field checkerPos = BB_SCAN(bbCheckers);
+    const BitBoard bbTargetFields = AttackTables::between(kingPos, checkerPos) | bbCheckers;
+
+    Piece piece;
+    piece.player = player;
 
-        /* Pruefung: Eine Figur darf den eigenen King nicht durch einen Zug
-           in Schach setzen (z.B. "Weg freimachen"). Ist die Position der
-           aktuellen Figur bei den allOppTurns enthalten? -> Wenn ja, dann
-           verhindert die Figur evtl. dass der King im Schach
-           steht. */
-        if (BIT_ISSET(bbAllOppTurns, from)) {
-            const PlayerColor opp = togglePlayerColor(piece.player);
-            bool captured = false;
-            PieceType capturedPieceType = NoType;
-            // Zug anwenden (ziehen und evtl. schlagen)
-            BIT_CLEAR(cb.m_bb[piece.player][piece.type], from);
-            BIT_SET(cb.m_bb[piece.player][piece.type], to);
-            for (int pieceType = King; pieceType < NUM_PIECETYPES; pieceType++) {
-                if (BIT_ISSET(cb.m_bb[opp][pieceType], to)) {
-                    BIT_CLEAR(cb.m_bb[opp][pieceType], to);
-                    captured = true;
-                    capturedPieceType = static_cast<PieceType>(pieceType);
-                    break;
+    for (int pieceType = Queen; pieceType <= Pawn; pieceType++) {
+        piece.type = (PieceType) pieceType;
+
+        BitBoard bbCurPieceType = cb.m_bb[player][pieceType] & ~bbPinned;
+        while (bbCurPieceType != 0) {
+            const Field curPiecePos = BB_SCAN(bbCurPieceType);
+            BIT_CLEAR(bbCurPieceType, curPiecePos);
+
+            BitBoard bbTurns;
+            if (pieceType == Pawn) {
+                bbTurns = calcMoveTurns(piece, (BitBoard)1 << curPiecePos, 0, cb) & bbTargetFields;
+
+                // En passant auf ein Feld zwischen King und Angreifer
+                if (cb.m_enPassantSquare != ERR &&
+                        BIT_ISSET(bbTurns, cb.m_enPassantSquare) &&
+                        !isEnPassantLegal(player, curPiecePos, cb)) {
+                    BIT_CLEAR(bbTurns, cb.m_enPassantSquare);
                 }
+            } else {
+                bbTurns = cb.getAttacksFrom(curPiecePos) & bbTargetFields;
             }
-            cb.updateBitBoards();
 
-            // Danach pruefen ob King im Schach steht
-            BitBoard bbNewOppTurns = calcAllOppTurns(opp, cb);
-            BitBoard bbKingInCheck = cb.m_bb[piece.player][King] & bbNewOppTurns;
+            if (!sink(piece, curPiecePos, bbTurns)) return;
+        }
+    }
+
+    // Der schachgebende Pawn kann auch en passant geschlagen werden
+    if (cb.m_enPassantSquare != ERR && (bbCheckers & cb.m_bb[opp][Pawn]) != 0) {
+        BitBoard bbPawns = AttackTables::pawnAttacks(opp, cb.m_enPassantSquare) &
+                           cb.m_bb[player][Pawn] & ~bbPinned;
 
-            // Zug wieder rueckgaengig machen!
-            BIT_CLEAR(cb.m_bb[piece.player][piece.type], to);
-            BIT_SET(cb.m_bb[piece.player][piece.type], from);
-            if (captured) BIT_SET(cb.m_bb[opp][capturedPieceType], to);
-            cb.updateBitBoards();
+        while (bbPawns != 0) {
+            const Field from = BB_SCAN(bbPawns);
+            BIT_CLEAR(bbPawns, from);
 
-            // Falls King im Schach, Zug nicht aufnehmen
-            if (bbKingInCheck == cb.m_bb[piece.player][King]) {
-                continue;
+            if (isEnPassantLegal(player, from, cb)) {
+                if (!sink(Piece(player, Pawn), from, (BitBoard)1 << cb.m_enPassantSquare)) return;
             }
         }
+    }
+}
+
+void TurnGenerator::bitBoardToMoves(Piece piece,
+                                    Field from,
+                                    BitBoard bbTurns,
+                                    MoveList& movesOut) const {
+    Field to;
+
+    while (bbTurns != 0) {
+        to = BB_SCAN(bbTurns);
+        BIT_CLEAR(bbTurns, to);
 
         if ((rankFor(to) == Eight || rankFor(to) == One) && piece.type == Pawn) {
-            turnsOut.push_back(Turn::promotionQueen(piece, from, to));
-            turnsOut.push_back(Turn::promotionBishop(piece, from, to));
-            turnsOut.push_back(Turn::promotionRook(piece, from, to));
-            turnsOut.push_back(Turn::promotionKnight(piece, from, to));
+            movesOut.push_back(Move(from, to, Turn::PromotionQueen));
+            movesOut.push_back(Move(from, to, Turn::PromotionBishop));
+            movesOut.push_back(Move(from, to, Turn::PromotionRook));
+            movesOut.push_back(Move(from, to, Turn::PromotionKnight));
 
         } else {
-            turnsOut.push_back(Turn::move(piece, from, to));
+            movesOut.push_back(Move(from, to));
+        }
+    }
+}
+
+BitBoard TurnGenerator::calcPinnedPieces(PlayerColor player,
+                                         const ChessBoard& cb,
+                                         std::array<BitBoard, NUM_FIELDS>& pinRaysOut) const {
+    if (cb.m_bb[player][King] == 0) {
+        return 0;
+    }
+
+    const PlayerColor opp = togglePlayerColor(player);
+    const Field kingPos = BB_SCAN(cb.m_bb[player][King]);
+    const BitBoard bbAllPieces = cb.m_bb[White][AllPieces] | cb.m_bb[Black][AllPieces];
+    const BitBoard bbOppPieces = cb.m_bb[opp][AllPieces];
+
+    /* Gegnerische sliding pieces, die den King sehen wuerden, wenn man
+       die eigenen Figuren vom Brett naehme */
+    BitBoard bbSnipers =
+        (MagicBitBoards::rookAttacks(kingPos, bbOppPieces) &
+            (cb.m_bb[opp][Rook] | cb.m_bb[opp][Queen])) |
+        (MagicBitBoards::bishopAttacks(kingPos, bbOppPieces) &
+            (cb.m_bb[opp][Bishop] | cb.m_bb[opp][Queen]));
+
+    BitBoard bbPinned = 0;
+    while (bbSnipers != 0) {
+        const Field sniperPos = BB_SCAN(bbSnipers);
+        BIT_CLEAR(bbSnipers, sniperPos);
+
+        const BitBoard bbRay = AttackTables::between(kingPos, sniperPos);
+        const BitBoard bbBlockers = bbRay & bbAllPieces;
+
+        // Genau eine eigene Figur dazwischen -> gefesselt
+        if (bbBlockers != 0 && (bbBlockers & (bbBlockers - 1)) == 0 &&
+                (bbBlockers & cb.m_bb[player][AllPieces]) != 0) {
+            bbPinned |= bbBlockers;
+            pinRaysOut[BB_SCAN(bbBlockers)] = bbRay | ((BitBoard)1 << sniperPos);
         }
     }
+
+    return bbPinned;
+}
+
+bool TurnGenerator::isEnPassantLegal(PlayerColor player,
+                                     Field from,
+                                     const ChessBoard& cb) const {
+    if (cb.m_bb[player][King] == 0) {
+        return true;
+    }
+
+    /* Beim Schlagen en passant verschwinden zwei Figuren von derselben Reihe.
+       Das kann den King einem sliding piece aussetzen, was die Fesselungen
+       nicht abdecken. Daher die Stellung nach dem Zug pruefen. */
+    const PlayerColor opp = togglePlayerColor(player);
+    const Field kingPos = BB_SCAN(cb.m_bb[player][King]);
+    const Field to = cb.m_enPassantSquare;
+    const Field capturedPos = static_cast<Field>(player == White ? to - 8 : to + 8);
+
+    BitBoard bbAllPieces = cb.m_bb[White][AllPieces] | cb.m_bb[Black][AllPieces];
+    BIT_CLEAR(bbAllPieces, from);
+    BIT_CLEAR(bbAllPieces, capturedPos);
+    BIT_SET  (bbAllPieces, to);
+
+    return (MagicBitBoards::rookAttacks(kingPos, bbAllPieces) &
+                (cb.m_bb[opp][Rook] | cb.m_bb[opp][Queen])) == 0 &&
+           (MagicBitBoards::bishopAttacks(kingPos, bbAllPieces) &
+                (cb.m_bb[opp][Bishop] | cb.m_bb[opp][Queen])) == 0;
+}
+
+BitBoard TurnGenerator::calcAttackersTo(Field field,
+                                        PlayerColor attacker,
+                                        BitBoard bbAllPieces,
+                                        const ChessBoard& cb) const {
+    const BitBoard bbField = (BitBoard)1 << field;
+    const PlayerColor defender = togglePlayerColor(attacker);
+
+    return (calcPawnAttackTurns(bbField, cb.m_bb[attacker][Pawn], defender, ERR)) |
+           (calcKnightTurns(bbField, 0) & cb.m_bb[attacker][Knight]) |
+           (calcKingTurns(bbField, 0, 0) & cb.m_bb[attacker][King]) |
+           (MagicBitBoards::rookAttacks(field, bbAllPieces) &
+                (cb.m_bb[attacker][Rook] | cb.m_bb[attacker][Queen])) |
+           (MagicBitBoards::bishopAttacks(field, bbAllPieces) &
+                (cb.m_bb[attacker][Bishop] | cb.m_bb[attacker][Queen]));
 }
 
 BitBoard TurnGenerator::calcUnCheckFields(PlayerColor opp,
                                           const ChessBoard& cb) {
-    Piece piece;
-    piece.player = opp;
-    Field curPiecePos;
-    PlayerColor player = togglePlayerColor(opp);
-    BitBoard bbCurPieceType, bbCurPiece, bbTurns, bbKingInCheck;
-    BitBoard bbUnCheckFields = 0;
+    const PlayerColor player = togglePlayerColor(opp);
 
-    for (int pieceType = King; pieceType <= Pawn ; pieceType++) {
-        piece.type     = (PieceType) pieceType;
-        bbCurPieceType = cb.m_bb[opp][pieceType];
+    if (cb.m_bb[player][King] == 0) {
+        return 0;
+    }
 
-        while (bbCurPieceType != 0) {
-            bbCurPiece  = 0;
-            curPiecePos = BB_SCAN(bbCurPieceType);
-            BIT_CLEAR(bbCurPieceType, curPiecePos);
-            BIT_SET  (bbCurPiece,     curPiecePos);
-
-            bbTurns = calcMoveTurns(piece, bbCurPiece, 0, cb);
-            bbKingInCheck = cb.m_bb[player][King] & bbTurns;
-
-            /* Zunaechst herausfinden, welche gegnerische Figur den King
-               in Schach setzt */
-            if (bbKingInCheck == cb.m_bb[player][King]) {
-                if (pieceType == Pawn || pieceType == Knight || pieceType == King) {
-                    /* Bei den nonsliding pieces ist das gesuchte "unCheckField"
-                       nur die Position der Figur */
-                    BIT_SET(bbUnCheckFields, curPiecePos);
-                    return bbUnCheckFields;
-
-                } else {
-                    /* Bei den sliding pieces kommen alle Felder in Frage, die der
-                       gegnerischen Figur, die den King in Schach setzt, den Weg
-                       "abschneiden" koennen. */
-
-                    /* TODO: Die Pruefung kann eigentlich entfallen, da die
-                       King-BitBoards immer != 0 sind. Nur aufgrund der Testfaelle
-                       vorhanden. */
-                    Field kingPos = ERR;
-                    if (cb.m_bb[player][King] != 0) {
-                        kingPos = BB_SCAN(cb.m_bb[player][King]);
-                    }
-
-                    Rank kingRank = rankFor(kingPos);
-                    File kingFile = fileFor(kingPos);
-                    Rank pieceRank = rankFor(curPiecePos);
-                    File pieceFile = fileFor(curPiecePos);
-
-                    int dist = -10;
-                    int rankSign = -10;
-                    int fileSign = -10;
-
-                    if (kingRank < pieceRank) {
-                        // SW, S, SE
-                        dist = pieceRank - kingRank - 1;
-                        rankSign = -1;
-
-                        if (kingFile < pieceFile) {
-                            // SW
-                            fileSign = -1;
-                        } else if (kingFile == pieceFile) {
-                            // S
-                            fileSign = 0;
-                        } else if (kingFile > pieceFile) {
-                            // SE
-                            fileSign = 1;
-                        }
-
-                    } else if (kingRank == pieceRank) {
-                        // W, E
-                        rankSign = 0;
-
-                        if (kingFile < pieceFile) {
-                            // W
-                            dist = pieceFile - kingFile - 1;
-                            fileSign = -1;
-
-                        } else if (kingFile > pieceFile) {
-                            // E
-                            dist = kingFile - pieceFile - 1;
-                            fileSign = 1;
-                        }
-
-                    } else if (kingRank > pieceRank) {
-                        // NW, N, NE
-                        dist = kingRank - pieceRank - 1;
-                        rankSign = 1;
-
-                        if (kingFile < pieceFile) {
-                            // NW
-                            fileSign = -1;
-                        } else if (kingFile == pieceFile) {
-                            // N
-                            fileSign = 0;
-                        } else if (kingFile > pieceFile) {
-                            // NE
-                            fileSign = 1;
-                        }
-                    }
-
-                    int field = 0;
-                    for (int i = 1; i <= dist; i++) {
-                        field = (pieceRank + (i*rankSign)) * 8 +
-                                (pieceFile + (i*fileSign));
-                        BIT_SET(bbUnCheckFields, field);
-                    }
-
-                    // Und die Position der gegnerischen Figur
-                    BIT_SET(bbUnCheckFields, curPiecePos);
-
-                    return bbUnCheckFields;
-                }
-            }
-        }
+    const Field kingPos = BB_SCAN(cb.m_bb[player][King]);
+    const BitBoard bbAllPieces = cb.m_bb[White][AllPieces] | cb.m_bb[Black][AllPieces];
+    const BitBoard bbCheckers = calcAttackersTo(kingPos, opp, bbAllPieces, cb);
+
+    /* Kein Schach oder Doppelschach: Es gibt kein Feld, auf dem eine
+       andere Figur als der King das Schachgebot aufheben koennte */
+    if (bbCheckers == 0 || (bbCheckers & (bbCheckers - 1)) != 0) {
+        return 0;
     }
 
-    return 0;
+    /* Die schachgebende Figur schlagen oder bei sliding pieces den Weg
+       zum King "abschneiden" */
+    return AttackTables::between(kingPos, BB_SCAN(bbCheckers)) | bbCheckers;
 }
 
 BitBoard TurnGenerator::calcAllOppTurns(PlayerColor opp,
@@ -372,14 +710,12 @@ BitBoard TurnGenerator::calcAllOppTurns(PlayerColor opp,
           einfachen Move-Turns der Pawns gehoeren nicht dazu!
        -> Bei den sliding pieces muessen auch die Felder berechnet werden,
           die "hinter" gegnerischen Figuren liegen */
-    Piece piece;
     Field curPiecePos;
     PlayerColor player = togglePlayerColor(opp);
 
     BitBoard bbAllOppTurns = 0;
     BitBoard bbAllPieces = cb.m_bb[White][AllPieces] | cb.m_bb[Black][AllPieces];
     BitBoard bbAllPiecesWhitoutKing = bbAllPieces ^ cb.m_bb[player][King];
-    BitBoard bbCurPieceType, bbCurPiece;
 
     // short castle
     if (cb.m_shortCastleRight[opp]) {
@@ -390,48 +726,27 @@ BitBoard TurnGenerator::calcAllOppTurns(PlayerColor opp,
         bbAllOppTurns |= calcLongCastleTurns(opp, bbAllPieces, 0);
     }
 
-    // move turns
-    for (int pieceType = King; pieceType <= Pawn ; pieceType++) {
-        piece.type   = (PieceType) pieceType;
-        piece.player = opp;
-        bbCurPieceType = cb.m_bb[opp][pieceType];
-
-        if (pieceType == Pawn) {
-            // get all potential attacks of the pawns
-            bbAllOppTurns |= calcPawnAttackTurns(bbCurPieceType,
-                                                 0xFFFFFFFFFFFFFFFF,
-                                                 opp,
-                                                 cb.m_enPassantSquare);
-
-        } else if (pieceType == King) {
-            bbAllOppTurns |= calcKingTurns(bbCurPieceType, 0, 0);
-
-        } else if (pieceType == Knight) {
-            bbAllOppTurns |= calcKnightTurns(bbCurPieceType, 0);
+    // non sliding pieces; get all potential attacks of the pawns
+    bbAllOppTurns |= calcPawnAttackTurns(cb.m_bb[opp][Pawn],
+                                         0xFFFFFFFFFFFFFFFF,
+                                         opp,
+                                         cb.m_enPassantSquare);
+    bbAllOppTurns |= calcKingTurns(cb.m_bb[opp][King], 0, 0);
+    bbAllOppTurns |= calcKnightTurns(cb.m_bb[opp][Knight], 0);
+
+    // sliding pieces, queens are handled as both rook and bishop
+    BitBoard bbCurPieces = cb.m_bb[opp][Rook] | cb.m_bb[opp][Queen];
+    while (bbCurPieces != 0) {
+        curPiecePos = BB_SCAN(bbCurPieces);
+        BIT_CLEAR(bbCurPieces, curPiecePos);
+        bbAllOppTurns |= MagicBitBoards::rookAttacks(curPiecePos, bbAllPiecesWhitoutKing);
+    }
 
-        } else {
-            // sliding pieces
-            while (bbCurPieceType != 0) {
-                bbCurPiece  = 0;
-                curPiecePos = BB_SCAN(bbCurPieceType);
-                BIT_CLEAR(bbCurPieceType, curPiecePos);
-                BIT_SET  (bbCurPiece,     curPiecePos);
-
-                if (pieceType == Rook) {
-                    bbAllOppTurns |= calcRookTurns(bbCurPiece,
-                                                   bbAllPiecesWhitoutKing,
-                                                   bbAllPiecesWhitoutKing);
-                } else if (pieceType == Queen) {
-                    bbAllOppTurns |= calcQueenTurns(bbCurPiece,
-                                                    bbAllPiecesWhitoutKing,
-                                                    bbAllPiecesWhitoutKing);
-                } else if (pieceType == Bishop) {
-                    bbAllOppTurns |= calcBishopTurns(bbCurPiece,
-                                                     bbAllPiecesWhitoutKing,
-                                                     bbAllPiecesWhitoutKing);
-                }
-            }
-        }
+    bbCurPieces = cb.m_bb[opp][Bishop] | cb.m_bb[opp][Queen];
+    while (bbCurPieces != 0) {
+        curPiecePos = BB_SCAN(bbCurPieces);
+        BIT_CLEAR(bbCurPieces, curPiecePos);
+        bbAllOppTurns |= MagicBitBoards::bishopAttacks(curPiecePos, bbAllPiecesWhitoutKing);
     }
 
     return bbAllOppTurns;
@@ -440,7 +755,7 @@ BitBoard TurnGenerator::calcAllOppTurns(PlayerColor opp,
 BitBoard TurnGenerator::calcMoveTurns(Piece piece,
                                       BitBoard bbPiece,
                                       BitBoard bbAllOppTurns,
-                                      const ChessBoard& cb) {
+                                      const ChessBoard& cb) const {
     PlayerColor opp = (piece.player == White) ? Black : White;
 
     switch (piece.type) {
@@ -473,7 +788,7 @@ BitBoard TurnGenerator::calcMoveTurns(Piece piece,
 
 BitBoard TurnGenerator::calcShortCastleTurns(PlayerColor player,
                                              BitBoard bbAllPieces,
-                                             BitBoard bbAllOppTurns) {
+                                             BitBoard bbAllOppTurns) const {
     BitBoard bbShortCastleKingTurn = 0;
 
     if (player == White) {
@@ -495,7 +810,7 @@ BitBoard TurnGenerator::calcShortCastleTurns(PlayerColor player,
 
 BitBoard TurnGenerator::calcLongCastleTurns(PlayerColor player,
                                             BitBoard bbAllPieces,
-                                            BitBoard bbAllOppTurns) {
+                                            BitBoard bbAllOppTurns) const {
     BitBoard bbLongCastleKingTurn = 0;
 
     if (player == White) {
@@ -527,92 +842,15 @@ BitBoard TurnGenerator::calcQueenTurns(BitBoard queens,
 BitBoard TurnGenerator::calcBishopTurns(BitBoard bishops,
                                         BitBoard allOppPieces,
                                         BitBoard allPieces) const {
-    BitBoard bbNE = getBitsNE(bishops);
-    BitBoard bbNW = getBitsNW(bishops);
-    BitBoard bbSE = getBitsSE(bishops);
-    BitBoard bbSW = getBitsSW(bishops);
-
-    // north east moves
-    BitBoard neMoves = bbNE & allPieces;
-    neMoves = (neMoves <<  9) | (neMoves << 18) | (neMoves << 27) |
-              (neMoves << 36) | (neMoves << 45) | (neMoves << 54);
-    neMoves &= bbNE;
-    neMoves ^= bbNE;
-    neMoves &= (allOppPieces | ~(allPieces));
-
-    // north west moves
-    BitBoard nwMoves = bbNW & allPieces;
-    nwMoves = (nwMoves <<  7) | (nwMoves << 14) | (nwMoves << 21) |
-              (nwMoves << 28) | (nwMoves << 35) | (nwMoves << 42);
-    nwMoves &= bbNW;
-    nwMoves ^= bbNW;
-    nwMoves &= (allOppPieces | ~(allPieces));
-
-    // south east movespp
-    BitBoard seMoves = bbSE & allPieces;
-    seMoves = (seMoves >>  7) | (seMoves >> 14) | (seMoves >> 21) |
-              (seMoves >> 28) | (seMoves >> 35) | (seMoves >> 42);
-    seMoves &= bbSE;
-    seMoves ^= bbSE;
-    seMoves &= (allOppPieces | ~(allPieces));
-
-    // south west moves
-    BitBoard swMoves = bbSW & allPieces;
-    swMoves = (swMoves >>  9) | (swMoves >> 18) | (swMoves >> 27) |
-              (swMoves >> 36) | (swMoves >> 45) | (swMoves >> 54);
-    swMoves &= bbSW;
-    swMoves ^= bbSW;
-    swMoves &= (allOppPieces | ~(allPieces));
-
-    return neMoves | nwMoves | seMoves | swMoves;
+    const BitBoard bbAttacks = MagicBitBoards::bishopAttacks(BB_SCAN(bishops), allPieces);
+    return bbAttacks & (allOppPieces | ~(allPieces));
 }
 
 BitBoard TurnGenerator::calcRookTurns(BitBoard rooks,
                                       BitBoard allOppPieces,
                                       BitBoard allPieces) const {
-    BitBoard bbE = getBitsE(rooks);
-    BitBoard bbW = getBitsW(rooks);
-    BitBoard bbN = getBitsN(rooks);
-    BitBoard bbS = getBitsS(rooks);
-
-    // right moves
-    BitBoard eastMoves = bbE & allPieces;
-    eastMoves = (eastMoves << 1) | (eastMoves << 2) | (eastMoves << 3) |
-                (eastMoves << 4) | (eastMoves << 5) | (eastMoves << 6) |
-                (eastMoves << 7);
-    eastMoves &= bbE;
-    eastMoves ^= bbE;
-    eastMoves &= (allOppPieces | ~(allPieces));
-
-    // west moves
-    BitBoard westMoves = bbW & allPieces;
-    westMoves = (westMoves >> 1) | (westMoves >> 2) | (westMoves >> 3) |
-                (westMoves >> 4) | (westMoves >> 5) | (westMoves >> 6) |
-                (westMoves >> 7);
-    westMoves &= bbW;
-    westMoves ^= bbW;
-    westMoves &= (allOppPieces | ~(allPieces));
-
-    // north moves
-    BitBoard northMoves = bbN & allPieces;
-    northMoves = (northMoves <<  8) | (northMoves << 16) | (northMoves << 24) |
-                (northMoves << 32) | (northMoves << 40) | (northMoves << 48) |
-                (northMoves << 56);
-    northMoves &= bbN;
-    northMoves ^= bbN;
-    northMoves &= (allOppPieces | ~(allPieces));
-
-
-    // south moves
-    BitBoard southMoves = bbS & allPieces;
-    southMoves = (southMoves >> 8) | (southMoves >> 16) | (southMoves >> 24) |
-                (southMoves >> 32) | (southMoves >> 40) | (southMoves >> 48) |
-                (southMoves >> 56);
-    southMoves &= bbS;
-    southMoves ^= bbS;
-    southMoves &= (allOppPieces | ~(allPieces));
-
-    return eastMoves | westMoves | northMoves | southMoves;
+    const BitBoard bbAttacks = MagicBitBoards::rookAttacks(BB_SCAN(rooks), allPieces);
+    return bbAttacks & (allOppPieces | ~(allPieces));
 }
 
 BitBoard TurnGenerator::calcKingTurns(BitBoard king,
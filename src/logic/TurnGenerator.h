@@ -34,6 +34,7 @@
 
 #include "ChessTypes.h"
 #include "ChessBoard.h"
+#include "MoveList.h"
 
 /**
  * @brief Turn generation (based on bitboards) and gameover detection.
@@ -41,10 +42,10 @@
 class TurnGenerator {
 public:
     /**
-     * @brief Returns the generated turns.
+     * @brief Returns the generated turns as packed moves.
      * @warning The generateTurns-function needs to be called previously.
      */
-    std::vector<Turn> getTurnList() const;
+    const MoveList& getMoveList() const;
 
     //! Generates turns for the given player color, based on the given chessboard.
     void generateTurns(PlayerColor player, ChessBoard& cb);
@@ -52,38 +53,126 @@ public:
     //! Sets the kingInCheck-Flag, based on the given chessboard.
     void initFlags(ChessBoard &cb);
 
+    /**
+     * @brief Sets the kingInCheck, checkmate and stalemate flags like
+     * generateTurns does, but stops at the first legal turn found and
+     * doesn't touch the turn list.
+     */
+    void updateFlags(PlayerColor player, ChessBoard& cb) const;
+    //! Returns true if player has a legal turn. Stops at the first one found.
+    bool hasAnyLegalMove(PlayerColor player, const ChessBoard& cb) const;
+    //! Counts the legal turns of player without creating turn objects.
+    size_t countLegalMoves(PlayerColor player, const ChessBoard& cb) const;
+    /**
+     * @brief Appends the legal captures (including en passant) and queen
+     * promotions of player to movesOut. Other promotions are left out.
+     */
+    void generateCaptures(PlayerColor player,
+                          const ChessBoard& cb,
+                          MoveList& movesOut) const;
+    /**
+     * @brief Appends the legal turns of player generateCaptures leaves out
+     * (quiet turns, castles and promotions to other pieces than the queen)
+     * to movesOut.
+     */
+    void generateQuiets(PlayerColor player,
+                        const ChessBoard& cb,
+                        MoveList& movesOut) const;
+    /**
+     * @brief Returns true if move is a legal turn of player. Only the moved
+     * piece is looked at, no turns are generated unless player is in check.
+     */
+    bool isLegalMove(PlayerColor player,
+                     const ChessBoard& cb,
+                     Move move) const;
+
 //private: /* provide access for gtest functions */
 
-    //! Creates turn objects from bitboards and adds it to turnsOut list
-    void bitBoardToTurns(Piece piece,
+    /**
+     * @brief Calculates the legal turns of player as target bitboards per
+     * piece. Generation and counting share it by passing different sinks.
+     * The sink is called as sink(piece, from, bbTurns) for moves and as
+     * sink.castle(turn) for castles and returns false to stop visiting.
+     * @return True if the king of player is in check.
+     */
+    template <class TurnSink>
+    bool visitLegalTurns(PlayerColor player,
+                         const ChessBoard& cb,
+                         TurnSink& sink) const;
+    /**
+     * @brief Visits the turns of player whose king is attacked by
+     * bbCheckers. In double check only king turns are visited, in
+     * single check also captures of the checker and interpositions.
+     */
+    template <class TurnSink>
+    void visitEvasions(PlayerColor player,
+                       BitBoard bbCheckers,
+                       BitBoard bbPinned,
+                       const ChessBoard& cb,
+                       TurnSink& sink) const;
+    /**
+     * @brief Returns the legal target fields of the piece on from while
+     * player isn't in check.
+     */
+    BitBoard calcLegalTurnsFrom(Piece piece,
+                                Field from,
+                                BitBoard bbAllOppTurns,
+                                BitBoard bbPinned,
+                                const std::array<BitBoard, NUM_FIELDS>& pinRays,
+                                const ChessBoard& cb) const;
+    /**
+     * @brief Returns true if the king of opp is attacked although it is
+     * not opp's turn. Only happens for boards of already ended games.
+     */
+    bool isOppKingAttacked(PlayerColor opp, const ChessBoard& cb) const;
+
+    //! Creates moves from bitboards and adds them to movesOut list
+    void bitBoardToMoves(Piece piece,
                          Field from,
                          BitBoard bbTurns,
-                         BitBoard bbAllOppTurns,
-                         ChessBoard& cb,
-                         Turns& turnsOut);
+                         MoveList& movesOut) const;
+
+    /**
+     * @brief Calculates the pieces of player pinned to their king.
+     * For every pinned piece the fields it may still move to (the ray
+     * between king and pinning piece, including the latter) are stored
+     * in pinRaysOut. Other entries are left untouched.
+     */
+    BitBoard calcPinnedPieces(PlayerColor player,
+                              const ChessBoard& cb,
+                              std::array<BitBoard, NUM_FIELDS>& pinRaysOut) const;
+    //! Checks whether the en passant capture from the given field exposes the king.
+    bool isEnPassantLegal(PlayerColor player,
+                          Field from,
+                          const ChessBoard& cb) const;
+    //! Returns all pieces of attacker attacking the given field.
+    BitBoard calcAttackersTo(Field field,
+                             PlayerColor attacker,
+                             BitBoard bbAllPieces,
+                             const ChessBoard& cb) const;
 
     //! Calculates all "normal" move turns
     BitBoard calcMoveTurns(Piece piece,
                            BitBoard bbPiece,
                            BitBoard bbAllOppTurns,
-                           const ChessBoard& cb);
+                           const ChessBoard& cb) const;
     //! Calculates a bitboard with all possible opponent turns
     BitBoard calcAllOppTurns(PlayerColor opp,
                              const ChessBoard& cb);
     /**
      * @brief If king is in check position, this function calculates
-     * a bitboard with possible fields to uncheck the king.
+     * a bitboard with possible fields to uncheck the king. 0 on double check.
      */
     BitBoard calcUnCheckFields(PlayerColor opp,
                                const ChessBoard& cb);
     //! Checks the requirements for the short castle turn.
     BitBoard calcShortCastleTurns(PlayerColor player,
                                   BitBoard bbAllPieces,
-                                  BitBoard bbAllOppTurns);
+                                  BitBoard bbAllOppTurns) const;
     //! Checks the requirements for the long castle turn.
     BitBoard calcLongCastleTurns(PlayerColor player,
                                  BitBoard bbAllPieces,
-                                 BitBoard bbAllOppTurns);
+                                 BitBoard bbAllOppTurns) const;
 
     /* Turn generation for the sliding pieces */
 
@@ -142,8 +231,8 @@ public:
     BitBoard getBitsSE(BitBoard bbPiece) const;
     BitBoard getBitsSW(BitBoard bbPiece) const;
 
-    //! Contains the generated turns.
-    std::vector<Turn> turnList;
+    //! Contains the generated turns as packed moves.
+    MoveList moveList;
 };
 
 inline BitBoard TurnGenerator::maskRank(Rank rank) const {
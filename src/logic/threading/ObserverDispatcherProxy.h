@@ -46,6 +46,7 @@
  * 
  * This proxy will serialize calls coming in from the game logic in a thread-safe
  * way and replay them once its poll method is called in the customers thread.
+ * Game states are queued as PackedPosition and unpacked again on replay.
  */
 class ObserverDispatcherProxy : public AbstractGameObserver, public ServiceDispatcher {
 public:
@@ -56,8 +57,9 @@ public:
     }
     
     virtual void onGameStart(GameState state, GameConfiguration config ) override {
+        const PackedPosition position = state.toPackedPosition();
         post([=] {
-            m_observer->onGameStart(state, config);
+            m_observer->onGameStart(GameState::fromPackedPosition(position), config);
         });
     }
     
@@ -68,8 +70,9 @@ public:
     }
     
     virtual void onTurnEnd(PlayerColor who, Turn turn, GameState newState) override {
+        const PackedPosition position = newState.toPackedPosition();
         post([=] {
-            m_observer->onTurnEnd(who, turn, newState);
+            m_observer->onTurnEnd(who, turn, GameState::fromPackedPosition(position));
         });
     }
     
@@ -80,8 +83,9 @@ public:
     }
     
     virtual void onGameOver(GameState state, PlayerColor winner) override {
+        const PackedPosition position = state.toPackedPosition();
         post([=] {
-            m_observer->onGameOver(state, winner);
+            m_observer->onGameOver(GameState::fromPackedPosition(position), winner);
         });
     }
     
@@ -46,6 +46,7 @@
  * 
  * This proxy will serialize calls coming in from the game logic in a thread-safe
  * way and replay them once its poll method is called in the customers thread.
+ * Game states are queued as PackedPosition and unpacked again on replay.
  */
 class PlayerDispatcherProxy : public AbstractPlayer, public ServiceDispatcher {
 public:
@@ -77,8 +78,9 @@ public:
     }
     
     virtual void onGameStart(GameState state, GameConfiguration config ) override {
+        const PackedPosition position = state.toPackedPosition();
         post([=] {
-            m_player->onGameStart(state, config);
+            m_player->onGameStart(GameState::fromPackedPosition(position), config);
         });
     }
     
@@ -89,8 +91,9 @@ public:
     }
     
     virtual void onTurnEnd(PlayerColor who, Turn turn, GameState newState) override {
+        const PackedPosition position = newState.toPackedPosition();
         post([=] {
-            m_player->onTurnEnd(who, turn, newState);
+            m_player->onTurnEnd(who, turn, GameState::fromPackedPosition(position));
         });
     }
     
@@ -101,8 +104,9 @@ public:
     }
     
     virtual void onGameOver(GameState state, PlayerColor winner) override {
+        const PackedPosition position = state.toPackedPosition();
         post([=] {
-            m_player->onGameOver(state, winner);
+            m_player->onGameOver(GameState::fromPackedPosition(position), winner);
         });
     }
     
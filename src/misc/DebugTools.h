@@ -51,34 +51,34 @@ namespace DebugTools {
 std::string toInitializerList(const std::array<Piece, 64>& board);
 
 /**
- * @brief Generates a random GameState.
+ * @brief Generates a random position.
  * Emulating a games a game with up to maxTurns random moves.
  * @param maxTurns Limit for number of moves.
  * @param rng C++ Random number generator to use.
  */
 template <typename Rng>
-GameState generateRandomState(size_t maxTurns, Rng& rng) {
+PackedPosition generateRandomPosition(size_t maxTurns, Rng& rng) {
     std::uniform_int_distribution<size_t> dst(0, maxTurns);
     const size_t turnCount = dst(rng);
 
     GameState gs;
     for (size_t i = 0; i < turnCount; ++i) {
-        auto turns = gs.getTurnList();
-        auto turn = random_selection(turns, rng);
-        if (turn == end(turns)) break;
-        gs.applyTurn(*turn);
+        const MoveList& moves = gs.getMoveList();
+        auto move = random_selection(moves, rng);
+        if (move == std::end(moves)) break;
+        gs.applyTurn(move->toTurn(gs.getChessBoard()));
     }
 
-    return gs;
+    return gs.toPackedPosition();
 }
 
 /**
 * @brief Generates a random Board.
-* @see generateRandomState
+* @see generateRandomPosition
 */
 template <typename Rng>
 ChessBoard generateRandomBoard(size_t maxTurns, Rng& rng) {
-    return generateRandomState(maxTurns, rng).getChessBoard();
+    return ChessBoard::fromPackedPosition(generateRandomPosition(maxTurns, rng));
 }
 
 
@@ -0,0 +1,133 @@
+/*
+    Copyright (c) 2013-2014, Stefan Hacker <dd0t@users.sourceforge.net>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "ai/MovePicker.h"
+
+using namespace std;
+
+TEST(MovePicker, stages) {
+    GameState gs(ChessBoard::fromFEN("4k3/8/8/3q4/4P3/2n5/1P6/R3K3 w - - 0 1"));
+    const MoveList& moves = gs.getMoveList();
+
+    const Move ttMove(E1, F2);
+    const MovePicker<GameState, MoveList>::Killers killers = {{ Move(A1, A7), Move(E4, D5) }};
+
+    MovePicker<GameState, MoveList> picker(gs, ttMove, killers);
+
+    vector<Turn> picked;
+    while (const Move* move = picker.next()) {
+        picked.push_back(move->toTurn(gs.getChessBoard()));
+    }
+
+    ASSERT_EQ(moves.size(), picked.size());
+    EXPECT_TRUE(turnVecCompare(gs.getTurnList(), picked));
+
+    // TT turn, captures by MVV-LVA, killers (capture killers are skipped)
+    EXPECT_EQ(Turn::move(Piece(White, King), E1, F2), picked[0]);
+    EXPECT_EQ(Turn::move(Piece(White, Pawn), E4, D5), picked[1]);
+    EXPECT_EQ(Turn::move(Piece(White, Pawn), B2, C3), picked[2]);
+    EXPECT_EQ(Turn::move(Piece(White, Rook), A1, A7), picked[3]);
+
+    for (size_t i = 4; i < picked.size(); ++i) {
+        EXPECT_EQ(NOT_A_CAPTURE, captureOrderScore(gs, Move(picked[i]))) << picked[i];
+    }
+}
+
+TEST(MovePicker, unordered) {
+    GameState gs;
+    const MoveList& moves = gs.getMoveList();
+
+    MovePicker<GameState, MoveList> picker(gs, Move(G1, F3),
+                                           {{ Move(), Move() }}, false);
+
+    for (const Move& move: moves) {
+        const Move* picked = picker.next();
+        ASSERT_NE(nullptr, picked);
+        EXPECT_EQ(move, *picked);
+    }
+    EXPECT_EQ(nullptr, picker.next());
+}
+
+TEST(MovePicker, illegalTTMoveAndKillers) {
+    GameState gs(ChessBoard::fromFEN("4k3/8/8/3q4/4P3/2n5/1P6/R3K3 w - - 0 1"));
+
+    // Neither the TT turn nor the killers are possible here. The first
+    // killer starts on an empty field and ends on an occupied one.
+    const MovePicker<GameState, MoveList>::Killers killers = {{ Move(H1, D5), Move(B2, B4) }};
+    EXPECT_EQ(NOT_A_CAPTURE, captureOrderScore(gs, killers[0]));
+    MovePicker<GameState, MoveList> picker(gs, Move(E4, E6), killers);
+
+    vector<Turn> picked;
+    while (const Move* move = picker.next()) {
+        picked.push_back(move->toTurn(gs.getChessBoard()));
+    }
+
+    ASSERT_EQ(gs.getMoveList().size(), picked.size());
+    EXPECT_TRUE(turnVecCompare(gs.getTurnList(), picked));
+    EXPECT_EQ(Turn::move(Piece(White, Pawn), E4, D5), picked[0]);
+}
+
+TEST(MovePicker, capturesOnly) {
+    GameState gs(ChessBoard::fromFEN("4k3/8/8/3q4/4P3/2n5/1P6/R3K3 w - - 0 1"));
+
+    MovePicker<GameState, MoveList> picker(gs, Move(E1, F2), {{ Move(A1, A7), Move() }},
+                                           true, true);
+
+    const Move* first = picker.next();
+    ASSERT_NE(nullptr, first);
+    EXPECT_EQ(Move(E4, D5), *first);
+    const Move* second = picker.next();
+    ASSERT_NE(nullptr, second);
+    EXPECT_EQ(Move(B2, C3), *second);
+    EXPECT_EQ(nullptr, picker.next());
+}
+
+TEST(MovePicker, inCheck) {
+    // Only evasions are legal, the killer moving elsewhere must be skipped
+    GameState gs(ChessBoard::fromFEN("4k3/8/8/8/8/8/3PPq2/R3K3 w Q - 0 1"));
+    ASSERT_TRUE(gs.getChessBoard().getKingInCheck()[White]);
+
+    MovePicker<GameState, MoveList> picker(gs, Move(E1, C1, Turn::Castle),
+                                           {{ Move(A1, A7), Move(E1, D1) }});
+
+    vector<Turn> picked;
+    while (const Move* move = picker.next()) {
+        picked.push_back(move->toTurn(gs.getChessBoard()));
+    }
+
+    EXPECT_TRUE(turnVecCompare(gs.getTurnList(), picked));
+    ASSERT_EQ(2U, picked.size());
+    EXPECT_EQ(Turn::move(Piece(White, King), E1, F2), picked[0]);
+    EXPECT_EQ(Turn::move(Piece(White, King), E1, D1), picked[1]);
+}
@@ -32,6 +32,7 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include <vector>
+#include <algorithm>
 #include <random>
 #include "ai/Negamax.h"
 #include "logic/IncrementalMaterialAndPSTEvaluator.h"
@@ -47,9 +48,11 @@ class MockGameState {
 public:
     MockGameState() : nextPlayer(White) {}
     virtual bool isGameOver() { return false; }
+    virtual bool isRepetition() const { return false; }
     virtual PlayerColor getNextPlayer() const { return nextPlayer; }
-    virtual std::vector<Turn> getTurnList() { return std::vector<Turn> { Turn() }; }
-    virtual void applyTurn(Turn) { nextPlayer = togglePlayerColor(nextPlayer); }
+    virtual std::vector<Turn> getTurnList() const { return std::vector<Turn> { Turn() }; }
+    virtual void makeTurn(Turn) { nextPlayer = togglePlayerColor(nextPlayer); }
+    virtual void unmakeTurn() { nextPlayer = togglePlayerColor(nextPlayer); }
     virtual Score getScore(size_t) const { return 0; }
     virtual Score getHash() const { return 0; }
 
@@ -60,8 +63,9 @@ class MockGameOver : public MockGameState {
 public:
     virtual bool isGameOver() override { return true; }
     virtual PlayerColor getNextPlayer() const override { return NoPlayer; }
-    virtual std::vector<Turn> getTurnList() override { return std::vector<Turn>(); }
-    virtual void applyTurn(Turn) override { /* Nothing */ }
+    virtual std::vector<Turn> getTurnList() const override { return std::vector<Turn>(); }
+    virtual void makeTurn(Turn) override { /* Nothing */ }
+    virtual void unmakeTurn() override { /* Nothing */ }
 };
 
 
@@ -86,13 +90,20 @@ TEST(Negamax, searchDepthExhaustion) {
 struct MockIncreasingState : public MockGameState {
     MockIncreasingState() : score(-666) {}
 
-    virtual std::vector<Turn> getTurnList() override {
+    virtual std::vector<Turn> getTurnList() const override {
         return{ Turn(), Turn(), Turn() };
     }
 
-    virtual void applyTurn(Turn t) override {
+    virtual void makeTurn(Turn t) override {
+        previousScores.push_back(score);
         score = ++increasingScore;
-        MockGameState::applyTurn(t);
+        MockGameState::makeTurn(t);
+    }
+
+    virtual void unmakeTurn() override {
+        score = previousScores.back();
+        previousScores.pop_back();
+        MockGameState::unmakeTurn();
     }
 
     virtual Score getScore(size_t) const override {
@@ -100,12 +111,45 @@ struct MockIncreasingState : public MockGameState {
     }
 
     Score score;
+    std::vector<Score> previousScores;
     static Score increasingScore;
 };
 
 Score MockIncreasingState::increasingScore = 0;
 
 
+struct MockRepetitionState : public MockGameState {
+    MockRepetitionState() : ply(0) {}
+
+    virtual void makeTurn(Turn t) override {
+        ++ply;
+        MockGameState::makeTurn(t);
+    }
+
+    virtual void unmakeTurn() override {
+        --ply;
+        MockGameState::unmakeTurn();
+    }
+
+    // Every position two plies deep repeats an earlier one
+    virtual bool isRepetition() const override { return ply == 2; }
+
+    virtual Score getScore(size_t) const override {
+        return (nextPlayer == White) ? 100 : -100;
+    }
+
+    size_t ply;
+};
+
+TEST(Negamax, searchRepetitionIsDraw) {
+    Negamax<MockRepetitionState, true, false, false> negamax;
+
+    MockRepetitionState state;
+    auto result = negamax.search(state, 4);
+    EXPECT_TRUE(result.turn);
+    EXPECT_EQ(0, result.score);
+}
+
 TEST(Negamax, searchRelaxation) {
     Negamax<MockIncreasingState, false, false, false> negamax;
     {
@@ -117,8 +161,9 @@ TEST(Negamax, searchRelaxation) {
 
         /*        Search space                   Depth   Next turn color
          *              0                          0           W
-         *    1         2           3              1           B
-         * 4  5  6   7  8  9   (10) 11 12          2           W
+         *    1         5           9              1           B
+         * 2  3  4   6  7  8   (10) 11 12          2           W
+         * Turns are applied lazily so the search space is numbered depth first.
          */
         EXPECT_EQ(10, result.score);
         EXPECT_EQ(pow(3, 1) + pow(3, 2), MockIncreasingState::increasingScore);
@@ -134,11 +179,11 @@ TEST(Negamax, searchRelaxation) {
         EXPECT_TRUE(result.turn);
         /*        Search space                   Depth   Next turn color
          *              0                          0           W
-         *    1         2           3              1           B
-         * 4  5 (6)   7  8  9    10 11 12          2           W
+         *    1         5           9              1           B
+         * 2  3 (4)   6  7  8    10 11 12          2           W
          */
 
-        EXPECT_EQ(-6, result.score);
+        EXPECT_EQ(-4, result.score);
         EXPECT_EQ(pow(3, 1) + pow(3, 2), MockIncreasingState::increasingScore);
     }
 }
@@ -182,8 +227,10 @@ TEST(Negamax, AlphaBetaCutoff) {
     uniform_int_distribution<size_t> depthDist(3, 4);
 
     for (size_t i = 0; i < TRIES; ++i) {
-        Negamax<GameState, false, false, false> negamax;
-        Negamax<GameState, true, false, false> negamaxAB;
+        // Quiescence search would make the search without cutoffs take ages.
+        // Null move pruning may change results.
+        Negamax<GameState, false, false, false, false, false, false> negamax;
+        Negamax<GameState, true, false, false, false, false, false> negamaxAB;
         
         GameState gs(generateRandomBoard(50, rng));
 
@@ -212,13 +259,13 @@ TEST(Negamax, TranspositionTableWithMoveOrdering) {
         
         const size_t depth = depthDist(rng);
         auto withTTMO = negamaxTTMO.search(gs, depth);
-        auto ttdur = negamaxTTMO.m_counters.duration;
+        const auto ttNodes = negamaxTTMO.m_counters.nodes;
         auto withTTMO2 = negamaxTTMO.search(gs,depth);
-        EXPECT_GT(ttdur, negamaxTTMO.m_counters.duration);
+        EXPECT_GT(ttNodes, negamaxTTMO.m_counters.nodes);
         EXPECT_LT(0, negamaxTTMO.m_counters.transpositionTableHits);
         
         auto withoutTTMO = negamaxAB.search(gs, depth);
-        EXPECT_GT(negamaxAB.m_counters.duration, negamaxTTMO.m_counters.duration);
+        EXPECT_GT(negamaxAB.m_counters.nodes, ttNodes);
         EXPECT_EQ(0, negamaxAB.m_counters.transpositionTableHits);
         
         EXPECT_EQ(withoutTTMO.score, withTTMO.score)
@@ -247,13 +294,13 @@ TEST(Negamax, TranspositionTable) {
         
         const size_t depth = depthDist(rng);
         auto withTT = negamaxTT.search(gs, depth);
-        auto ttdur = negamaxTT.m_counters.duration;
+        const auto ttNodes = negamaxTT.m_counters.nodes;
         auto withTT2 = negamaxTT.search(gs,depth);
-        EXPECT_GT(ttdur, negamaxTT.m_counters.duration);
+        EXPECT_GT(ttNodes, negamaxTT.m_counters.nodes);
         EXPECT_LT(0, negamaxTT.m_counters.transpositionTableHits);
         
         auto withoutTT = negamaxAB.search(gs, depth);
-        EXPECT_GT(negamaxAB.m_counters.duration, negamaxTT.m_counters.duration);
+        EXPECT_GT(negamaxAB.m_counters.nodes, ttNodes);
         EXPECT_EQ(0, negamaxAB.m_counters.transpositionTableHits);
         
         EXPECT_EQ(withoutTT, withTT)
@@ -301,3 +348,186 @@ TEST(Negamax, TTMORegression) {
             << "Depth: " << depth << endl;
     
 }
+
+TEST(Negamax, LazySMP) {
+    const unsigned int TRIES = 3;
+    const size_t depth = 4;
+
+    mt19937 rng(4711);
+    for (size_t i = 0; i < TRIES; ++i) {
+        Negamax<GameState, true, true, true> negamax;
+        Negamax<GameState, true, true, true> negamaxSMP(4);
+        EXPECT_EQ(1, negamax.getThreads());
+        EXPECT_EQ(4, negamaxSMP.getThreads());
+
+        GameState gs(generateRandomBoard(50, rng));
+        if (gs.isGameOver()) continue;
+
+        auto single = negamax.search(gs, depth);
+        auto parallel = negamaxSMP.search(gs, depth);
+
+        // Helpers may supply deeper results so only legality is guaranteed
+        ASSERT_TRUE(parallel.turn) << "Base state (" << i << "): " << gs << endl;
+        const auto& turns = gs.getTurnList();
+        EXPECT_NE(turns.end(), find(turns.begin(), turns.end(), parallel.turn.get()))
+                << "Base state (" << i << "): " << gs << endl;
+        EXPECT_LE(negamax.m_counters.nodes, negamaxSMP.m_counters.nodes);
+        EXPECT_TRUE(single.turn);
+    }
+
+    // Forced results must not change
+    GameState mateInOne(ChessBoard::fromFEN("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1"));
+    Negamax<GameState, true, true, true> negamax;
+    Negamax<GameState, true, true, true> negamaxSMP(4);
+    auto single = negamax.search(mateInOne, 3);
+    auto parallel = negamaxSMP.search(mateInOne, 3);
+    EXPECT_TRUE(single.isVictoryCertain());
+    EXPECT_EQ(single, parallel);
+}
+
+TEST(Negamax, PrincipalVariationSearch) {
+    const unsigned int TRIES = 5;
+
+    mt19937 rng(2718);
+    uniform_int_distribution<size_t> depthDist(3, 4);
+    for (size_t i = 0; i < TRIES; ++i) {
+        Negamax<GameState, true, true, false, false> negamaxAB;
+        Negamax<GameState, true, true, false, true> negamaxPVS;
+
+        GameState gs(generateRandomBoard(50, rng));
+
+        const size_t depth = depthDist(rng);
+        auto withPVS = negamaxPVS.search(gs, depth);
+        auto withoutPVS = negamaxAB.search(gs, depth);
+
+        EXPECT_EQ(0, negamaxAB.m_counters.nullWindowSearches);
+        EXPECT_LT(0, negamaxPVS.m_counters.nullWindowSearches);
+        EXPECT_GE(negamaxPVS.m_counters.nullWindowSearches, negamaxPVS.m_counters.researches);
+
+        EXPECT_EQ(withoutPVS.score, withPVS.score)
+                << "With PVS: " << withPVS << endl
+                << "Without PVS: " << withoutPVS << endl
+                << "Base state (" << i << "): " << gs << endl
+                << "Depth: " << depth << endl;
+    }
+}
+
+TEST(Negamax, AspirationWindows) {
+    const unsigned int TRIES = 5;
+
+    mt19937 rng(1618);
+    uniform_int_distribution<size_t> depthDist(3, 4);
+    for (size_t i = 0; i < TRIES; ++i) {
+        Negamax<GameState, true, true, false> negamax;
+
+        GameState gs(generateRandomBoard(50, rng));
+
+        const size_t depth = depthDist(rng);
+        auto fullWindow = negamax.search(gs, depth);
+        EXPECT_EQ(0, negamax.m_counters.aspirationResearches);
+
+        // A good guess needs no re-search
+        auto goodGuess = negamax.search(gs, depth, fullWindow.score);
+        EXPECT_EQ(0, negamax.m_counters.aspirationResearches);
+        EXPECT_EQ(fullWindow.score, goodGuess.score)
+                << "Base state (" << i << "): " << gs << endl;
+
+        // Bad guesses have to widen the window until the score is exact
+        if (fullWindow.score < -WIN_SCORE_THRESHOLD || fullWindow.score > WIN_SCORE_THRESHOLD) continue;
+
+        auto tooHigh = negamax.search(gs, depth, fullWindow.score + 300);
+        EXPECT_LT(0, negamax.m_counters.aspirationResearches);
+        EXPECT_EQ(fullWindow.score, tooHigh.score)
+                << "Base state (" << i << "): " << gs << endl;
+
+        auto tooLow = negamax.search(gs, depth, fullWindow.score - 300);
+        EXPECT_LT(0, negamax.m_counters.aspirationResearches);
+        EXPECT_EQ(fullWindow.score, tooLow.score)
+                << "Base state (" << i << "): " << gs << endl;
+    }
+}
+
+TEST(Negamax, QuiescenceSearch) {
+    // Qxe5 wins a pawn but loses the queen to dxe5 right behind the horizon
+    GameState gs(ChessBoard::fromFEN("4k3/8/3p4/4p3/8/8/7Q/4K3 w - - 0 1"));
+    const Turn poisonedPawn = Turn::move(Piece(White, Queen), H2, E5);
+
+    Negamax<GameState, true, true, false, true, false> negamax;
+    auto horizon = negamax.search(gs, 1);
+    ASSERT_TRUE(horizon.turn);
+    EXPECT_EQ(poisonedPawn, horizon.turn.get());
+    EXPECT_EQ(0, negamax.m_counters.quiescenceNodes);
+
+    Negamax<GameState, true, true, false, true, true> negamaxQS;
+    auto quiet = negamaxQS.search(gs, 1);
+    ASSERT_TRUE(quiet.turn);
+    EXPECT_NE(poisonedPawn, quiet.turn.get());
+    EXPECT_LT(0, negamaxQS.m_counters.quiescenceNodes);
+    EXPECT_LT(quiet.score, horizon.score);
+}
+
+TEST(Negamax, QuiescenceSearchMate) {
+    // Whatever white does Rxb1 mates, only the quiescence search sees it
+    GameState gs(ChessBoard::fromFEN("7k/8/8/8/4b3/pp6/7P/KNr5 w - - 0 1"));
+
+    Negamax<GameState, true, true, false, true, false> negamax;
+    auto horizon = negamax.search(gs, 1);
+    EXPECT_LT(LOOSE_SCORE + 2, horizon.score);
+
+    Negamax<GameState, true, true, false, true, true> negamaxQS;
+    auto mated = negamaxQS.search(gs, 1);
+    EXPECT_EQ(LOOSE_SCORE + 2, mated.score);
+}
+
+TEST(Negamax, NullMovePruning) {
+    const unsigned int TRIES = 5;
+    const size_t depth = 5;
+
+    mt19937 rng(1414);
+    uint64_t nullMoves = 0;
+    for (size_t i = 0; i < TRIES; ++i) {
+        Negamax<GameState, true, true, true, true, true, false> negamax;
+        Negamax<GameState, true, true, true, true, true, true> negamaxNM;
+
+        GameState gs(generateRandomBoard(40, rng));
+        if (gs.isGameOver()) continue;
+
+        auto withoutNullMove = negamax.search(gs, depth);
+        auto withNullMove = negamaxNM.search(gs, depth);
+        EXPECT_EQ(0, negamax.m_counters.nullMoves);
+        EXPECT_GE(negamaxNM.m_counters.nullMoves, negamaxNM.m_counters.nullMoveCutoffs);
+        nullMoves += negamaxNM.m_counters.nullMoves;
+
+        ASSERT_TRUE(withNullMove.turn) << "Base state (" << i << "): " << gs << endl;
+        const auto& turns = gs.getTurnList();
+        EXPECT_NE(turns.end(), find(turns.begin(), turns.end(), withNullMove.turn.get()));
+        EXPECT_TRUE(withoutNullMove.turn);
+    }
+    EXPECT_LT(0, nullMoves);
+
+    // Pawn endgames are prone to zugzwang, passing is never tried
+    GameState pawnEnding(ChessBoard::fromFEN("8/8/1p6/1P1k4/8/3K4/8/8 w - - 0 1"));
+    Negamax<GameState, true, true, true, true, true, true> negamaxNM;
+    negamaxNM.search(pawnEnding, depth);
+    EXPECT_EQ(0, negamaxNM.m_counters.nullMoves);
+}
+
+TEST(Negamax, repetitionBeforeRoot) {
+    // White is a queen down. Repeating the knight shuffle played before
+    // the search started is a draw, which only a search seeing the game's
+    // history can find.
+    GameState gs(ChessBoard::fromFEN("q3k1n1/8/8/8/8/8/8/4K1N1 w - - 0 1"));
+    gs.applyTurn(Turn::move(Piece(White, Knight), G1, F3));
+    gs.applyTurn(Turn::move(Piece(Black, Knight), G8, F6));
+    gs.applyTurn(Turn::move(Piece(White, Knight), F3, G1));
+    gs.applyTurn(Turn::move(Piece(Black, Knight), F6, G8));
+
+    for (size_t threads = 1; threads <= 2; ++threads) {
+        Negamax<> negamax(threads);
+        const NegamaxResult result = negamax.search(gs, 2);
+
+        EXPECT_EQ(0, result.score) << threads << " threads";
+        ASSERT_TRUE(result.turn);
+        EXPECT_EQ(Turn::move(Piece(White, Knight), G1, F3), result.turn.get());
+    }
+}
@@ -30,9 +30,14 @@
     POSSIBILITY OF SUCH DAMAGE.
 */
 #include <gtest/gtest.h>
+#include <future>
+#include <random>
+#include <vector>
 
 #include "ai/TranspositionTable.h"
 
+using namespace std;
+
 TEST(TranspositionTable, lookup) {
     TranspositionTable tbl;
     
@@ -50,3 +55,73 @@ TEST(TranspositionTable, lookup) {
     
     //TODO: Improve this
 }
+
+TEST(TranspositionTable, replacement) {
+    TranspositionTable tbl(101);
+
+    TranspositionTableEntry entry;
+    entry.hash = 5;
+    entry.score = -1234;
+    entry.turn = Move(E2, E4);
+    entry.depth = 3;
+    entry.boundType = TranspositionTableEntry::LOWER;
+    tbl.maybeUpdate(entry);
+
+    auto stored = tbl.lookup(5);
+    ASSERT_TRUE(stored);
+    EXPECT_EQ(-1234, stored->score);
+    EXPECT_EQ(Move(E2, E4), stored->turn);
+    EXPECT_EQ(3, stored->depth);
+    EXPECT_TRUE(stored->isLowerBound());
+
+    // Shallower entries for the same position don't replace deeper ones
+    entry.depth = 2;
+    entry.score = 10;
+    tbl.maybeUpdate(entry);
+    EXPECT_EQ(-1234, tbl.lookup(5)->score);
+
+    // Other positions do
+    entry.hash = 5 + 101;
+    tbl.maybeUpdate(entry);
+    EXPECT_FALSE(tbl.lookup(5));
+    EXPECT_EQ(10, tbl.lookup(5 + 101)->score);
+}
+
+TEST(TranspositionTable, concurrentAccess) {
+    const size_t THREADS = 4;
+    const size_t UPDATES = 200000;
+    TranspositionTable tbl(1009);
+
+    // Every thread stores entries whose content is derived from their
+    // hash. Any entry returned by lookup must be consistent.
+    auto worker = [&tbl, UPDATES](size_t seed) {
+        mt19937_64 rng(seed);
+        size_t inconsistent = 0;
+        for (size_t i = 0; i < UPDATES; ++i) {
+            const Hash hash = rng() | 1;
+            TranspositionTableEntry entry;
+            entry.hash = hash;
+            entry.score = static_cast<Score>(hash >> 32);
+            entry.turn = Move(static_cast<Field>(hash % 64), static_cast<Field>((hash >> 8) % 64));
+            entry.depth = static_cast<uint8_t>(hash >> 16);
+            entry.boundType = TranspositionTableEntry::EXACT;
+            tbl.maybeUpdate(entry);
+
+            auto found = tbl.lookup(hash);
+            if (found && (found->score != entry.score
+                          || found->turn != entry.turn
+                          || found->depth != entry.depth)) {
+                ++inconsistent;
+            }
+        }
+        return inconsistent;
+    };
+
+    vector<future<size_t>> results;
+    for (size_t i = 0; i < THREADS; ++i) {
+        results.push_back(async(launch::async, worker, i));
+    }
+    for (auto& result: results) {
+        EXPECT_EQ(0, result.get());
+    }
+}
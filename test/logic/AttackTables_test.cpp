@@ -0,0 +1,85 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <gtest/gtest.h>
+#include "logic/AttackTables.h"
+#include "logic/ChessBoard.h"
+
+TEST(AttackTables, knightAttacks) {
+    EXPECT_EQ(generateBitBoard(B3, C2, ERR), AttackTables::knightAttacks(A1));
+    EXPECT_EQ(generateBitBoard(C3, E3, B4, F4, B6, F6, C7, E7, ERR),
+              AttackTables::knightAttacks(D5));
+}
+
+TEST(AttackTables, kingAttacks) {
+    EXPECT_EQ(generateBitBoard(G8, G7, H7, ERR), AttackTables::kingAttacks(H8));
+    EXPECT_EQ(generateBitBoard(D1, F1, D2, E2, F2, ERR), AttackTables::kingAttacks(E1));
+}
+
+TEST(AttackTables, pawnAttacks) {
+    EXPECT_EQ(generateBitBoard(B3, ERR), AttackTables::pawnAttacks(White, A2));
+    EXPECT_EQ(generateBitBoard(G6, ERR), AttackTables::pawnAttacks(Black, H7));
+    EXPECT_EQ(generateBitBoard(D3, F3, ERR), AttackTables::pawnAttacks(Black, E4));
+
+    EXPECT_EQ(generateBitBoard(B3, D3, G3, ERR),
+              AttackTables::allPawnAttacks(White, generateBitBoard(A2, C2, H2, ERR)));
+    EXPECT_EQ(generateBitBoard(B6, G6, ERR),
+              AttackTables::allPawnAttacks(Black, generateBitBoard(A7, H7, ERR)));
+}
+
+TEST(AttackTables, attacks) {
+    const BitBoard allPieces = generateBitBoard(D4, D6, ERR);
+    EXPECT_EQ(MagicBitBoards::queenAttacks(D4, allPieces),
+              AttackTables::attacks(Piece(White, Queen), D4, allPieces));
+    EXPECT_EQ(AttackTables::knightAttacks(D4),
+              AttackTables::attacks(Piece(Black, Knight), D4, allPieces));
+    EXPECT_EQ(0U, AttackTables::attacks(Piece(NoPlayer, NoType), D4, allPieces));
+}
+
+TEST(AttackTables, between) {
+    EXPECT_EQ(generateBitBoard(B1, C1, D1, ERR), AttackTables::between(A1, E1));
+    EXPECT_EQ(generateBitBoard(E4, E3, E2, ERR), AttackTables::between(E5, E1));
+    EXPECT_EQ(generateBitBoard(G7, F6, E5, ERR), AttackTables::between(H8, D4));
+    EXPECT_EQ(generateBitBoard(B7, ERR), AttackTables::between(C6, A8));
+
+    EXPECT_EQ(0U, AttackTables::between(A1, B1));
+    EXPECT_EQ(0U, AttackTables::between(A1, B3));
+    EXPECT_EQ(0U, AttackTables::between(D4, D4));
+}
+
+TEST(AttackTables, line) {
+    EXPECT_EQ(generateBitBoard(A1, B1, C1, D1, E1, F1, G1, H1, ERR), AttackTables::line(C1, E1));
+    EXPECT_EQ(generateBitBoard(A7, B8, ERR), AttackTables::line(B8, A7));
+    EXPECT_EQ(generateBitBoard(A1, B2, C3, D4, E5, F6, G7, H8, ERR), AttackTables::line(F6, E5));
+    EXPECT_EQ(AttackTables::line(F6, E5), AttackTables::line(E5, F6));
+
+    EXPECT_EQ(0U, AttackTables::line(A1, B3));
+}
@@ -0,0 +1,77 @@
+/*
+    Copyright (c) 2013-2014, Stefan Hacker <dd0t@users.sourceforge.net>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <gtest/gtest.h>
+#include <random>
+#include "logic/BitOperations.h"
+
+using namespace std;
+
+TEST(BitOperations, scan) {
+    EXPECT_EQ(A1, BitOperations::scanReverse(1ULL));
+    EXPECT_EQ(H8, BitOperations::scanReverse(1ULL << H8));
+    EXPECT_EQ(E5, BitOperations::scanReverse((1ULL << C1) | (1ULL << E5)));
+    EXPECT_EQ(E5, BitOperations::scanReverseGeneric((1ULL << C1) | (1ULL << E5)));
+}
+
+TEST(BitOperations, extractBits) {
+    EXPECT_EQ(0ULL, BitOperations::extractBits(~0ULL, 0ULL));
+    EXPECT_EQ(0xFFULL, BitOperations::extractBits(~0ULL, 0xFF00000000000000ULL));
+    EXPECT_EQ(0x9ULL, BitOperations::extractBits(0x0000000100000100ULL,
+                                                 0x0000000110001100ULL));
+}
+
+TEST(BitOperations, dispatchedMatchesGeneric) {
+    // Whatever variant got selected for this CPU has to agree with the
+    // generic implementation.
+    mt19937_64 rng(1234);
+    for (int i = 0; i < 10000; ++i) {
+        const BitBoard bb = rng() & rng();
+        const BitBoard mask = rng() & rng();
+
+        EXPECT_EQ(BitOperations::popCountGeneric(bb), BitOperations::popCount(bb));
+        EXPECT_EQ(BitOperations::extractBitsGeneric(bb, mask), BitOperations::extractBits(bb, mask));
+        if (BitOperations::getCpuFeatures().bmi2) {
+            EXPECT_EQ(BitOperations::extractBitsGeneric(bb, mask), BitOperations::extractBitsBMI2(bb, mask));
+        }
+        if (bb != 0) {
+            EXPECT_EQ(BitOperations::scanReverseGeneric(bb), BitOperations::scanReverse(bb));
+        }
+    }
+}
+
+TEST(BitOperations, popCount) {
+    EXPECT_EQ(0, BitOperations::popCount(0ULL));
+    EXPECT_EQ(64, BitOperations::popCount(~0ULL));
+    EXPECT_EQ(0, BitOperations::popCountGeneric(0ULL));
+    EXPECT_EQ(64, BitOperations::popCountGeneric(~0ULL));
+    EXPECT_EQ(32, BitOperations::popCountGeneric(0xAAAAAAAAAAAAAAAAULL));
+}
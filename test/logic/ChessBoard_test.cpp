@@ -30,6 +30,7 @@
     POSSIBILITY OF SUCH DAMAGE.
 */
 #include <gtest/gtest.h>
+#include <cstring>
 #include "logic/ChessBoard.h"
 #include "misc/DebugTools.h"
 #include "logic/IncrementalMaterialAndPSTEvaluator.h"
@@ -177,6 +178,49 @@ TEST(ChessBoard, IncrementalHashing) {
     }
 }
 
+TEST(ChessBoard, IncrementalPawnAndMaterialHashing) {
+    mt19937 rng(8723);
+    const int TRIES = 100;
+    for (int i = 0; i < TRIES; ++i) {
+        ChessBoard cb = generateRandomBoard(100, rng);
+        ASSERT_EQ(IncrementalZobristHasher::hashPawnStructure(cb),
+            cb.getPawnHash()) << i << "th Board: " << cb;
+        ASSERT_EQ(IncrementalZobristHasher::hashMaterial(cb),
+            cb.getMaterialHash()) << i << "th Board: " << cb;
+    }
+}
+
+TEST(ChessBoard, PawnAndMaterialHashScope) {
+    ChessBoard cb;
+    const Hash pawnHash = cb.getPawnHash();
+    const Hash materialHash = cb.getMaterialHash();
+
+    // Piece moves keep the pawn structure and the material
+    cb.applyTurn(Turn::move(Piece(White, Knight), G1, F3));
+    EXPECT_EQ(pawnHash, cb.getPawnHash());
+    EXPECT_EQ(materialHash, cb.getMaterialHash());
+    EXPECT_NE(cb.getHash(), cb.getPawnHash());
+
+    // Pawn moves change the pawn structure only
+    cb.applyTurn(Turn::move(Piece(Black, Pawn), E7, E5));
+    EXPECT_NE(pawnHash, cb.getPawnHash());
+    EXPECT_EQ(materialHash, cb.getMaterialHash());
+
+    // Same material in a different placement shares the material key
+    ChessBoard a = ChessBoard::fromFEN("4k3/8/8/8/8/8/3PN3/4K3 w - - 0 1");
+    ChessBoard b = ChessBoard::fromFEN("3k4/8/2N5/8/5P2/8/8/K7 b - - 0 1");
+    EXPECT_EQ(a.getMaterialHash(), b.getMaterialHash());
+    EXPECT_NE(a.getPawnHash(), b.getPawnHash());
+
+    // Capturing or promoting changes the material
+    ChessBoard c = ChessBoard::fromFEN("1r2k3/P7/8/8/8/8/8/4K3 w - - 0 1");
+    const Hash before = c.getMaterialHash();
+    c.applyTurn(Turn::promotionQueen(Piece(White, Pawn), A7, B8));
+    EXPECT_NE(before, c.getMaterialHash());
+    EXPECT_EQ(IncrementalZobristHasher::hashMaterial(c), c.getMaterialHash());
+    EXPECT_EQ(IncrementalZobristHasher::hashPawnStructure(c), c.getPawnHash());
+}
+
 TEST(ChessBoard, MACRO_BB_SET) {
     mt19937 rng(45438);
     uniform_int_distribution<BitBoard> bbDist(1);
@@ -405,3 +449,140 @@ TEST(ChessBoard, HashAndScoreChangeWhenPromotingRegression) {
 
     EXPECT_EQ(cbAfterCastle, cb);
 }
+
+TEST(ChessBoard, IncrementalAttacksMatchFullCalculation) {
+    mt19937 rng(4711);
+
+    for (int game = 0; game < 20; ++game) {
+        GameState gs;
+
+        for (int i = 0; i < 100 && !gs.isGameOver(); ++i) {
+            const std::vector<Turn> turns = gs.getTurnList();
+            gs.applyTurn(*random_selection(turns, rng));
+
+            const ChessBoard& cb = gs.getChessBoard();
+            const ChessBoard fresh = ChessBoard::fromFEN(cb.toFEN());
+
+            for (Field field = A1; field <= H8; field = nextField(field)) {
+                ASSERT_EQ(fresh.getAttacksFrom(field), cb.getAttacksFrom(field))
+                        << field << " after " << i << " turns" << cb;
+            }
+            ASSERT_EQ(fresh.getAttacks(White), cb.getAttacks(White)) << cb;
+            ASSERT_EQ(fresh.getAttacks(Black), cb.getAttacks(Black)) << cb;
+        }
+    }
+}
+
+TEST(ChessBoard, MailboxMatchesBitBoards) {
+    mt19937 rng(815);
+
+    for (int game = 0; game < 20; ++game) {
+        GameState gs;
+
+        for (int i = 0; i < 100 && !gs.isGameOver(); ++i) {
+            const std::vector<Turn> turns = gs.getTurnList();
+            gs.applyTurn(*random_selection(turns, rng));
+
+            // Bit boards rebuilt from the mailbox have to match the board's own
+            const ChessBoard& cb = gs.getChessBoard();
+            const ChessBoard rebuilt(cb.getBoard(), cb.getNextPlayer(),
+                                     cb.getShortCastleRights(), cb.getLongCastleRights(),
+                                     cb.getEnPassantSquare(),
+                                     cb.getHalfMoveClock(), cb.getFullMoveClock());
+            ASSERT_EQ(rebuilt, cb) << "after " << i << " turns" << cb;
+        }
+    }
+}
+
+TEST(ChessBoard, PackedPosition) {
+    mt19937 rng(1337);
+
+    for (int game = 0; game < 20; ++game) {
+        GameState gs;
+
+        for (int i = 0; i < 100 && !gs.isGameOver(); ++i) {
+            const std::vector<Turn> turns = gs.getTurnList();
+            gs.applyTurn(*random_selection(turns, rng));
+
+            const ChessBoard& cb = gs.getChessBoard();
+            const PackedPosition position = cb.toPackedPosition();
+
+            // Has to survive a round trip through raw memory
+            unsigned char buffer[sizeof(PackedPosition)];
+            std::memcpy(buffer, &position, sizeof(PackedPosition));
+            PackedPosition copied;
+            std::memcpy(&copied, buffer, sizeof(PackedPosition));
+            ASSERT_EQ(position, copied);
+
+            const ChessBoard unpacked = ChessBoard::fromPackedPosition(copied);
+            ASSERT_EQ(cb, unpacked) << cb << unpacked;
+            ASSERT_EQ(cb.toFEN(), unpacked.toFEN());
+            ASSERT_EQ(cb.getLastCapturedPiece(), unpacked.getLastCapturedPiece());
+            ASSERT_EQ(position, unpacked.toPackedPosition());
+        }
+    }
+}
+
+TEST(ChessBoard, StaticExchangeEvaluation) {
+    {
+        // Undefended pawn
+        ChessBoard cb = ChessBoard::fromFEN("1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1");
+        EXPECT_EQ(100, cb.see(Turn::move(Piece(White, Rook), E1, E5)));
+    }
+    {
+        // Queen takes a defended pawn
+        ChessBoard cb = ChessBoard::fromFEN("4k3/8/2p5/3p4/8/8/8/3QK3 w - - 0 1");
+        EXPECT_EQ(-800, cb.see(Turn::move(Piece(White, Queen), D1, D5)));
+    }
+    {
+        // The rook behind the capturer wins the exchange by x-ray
+        ChessBoard cb = ChessBoard::fromFEN("3rk3/8/8/3p4/8/8/3R4/3RK3 w - - 0 1");
+        EXPECT_EQ(100, cb.see(Turn::move(Piece(White, Rook), D2, D5)));
+    }
+    {
+        // The king may only recapture undefended pieces
+        ChessBoard cb = ChessBoard::fromFEN("4k3/3p4/8/8/8/8/8/3RK3 w - - 0 1");
+        EXPECT_EQ(-400, cb.see(Turn::move(Piece(White, Rook), D1, D7)));
+
+        ChessBoard cbXRay = ChessBoard::fromFEN("4k3/3p4/8/8/8/8/3R4/3RK3 w - - 0 1");
+        EXPECT_EQ(100, cbXRay.see(Turn::move(Piece(White, Rook), D2, D7)));
+    }
+    {
+        ChessBoard cb = ChessBoard::fromFEN("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1");
+        EXPECT_EQ(100, cb.see(Turn::move(Piece(White, Pawn), E5, D6)));
+    }
+    {
+        ChessBoard cb = ChessBoard::fromFEN("4k3/P7/8/8/8/8/8/4K3 w - - 0 1");
+        EXPECT_EQ(800, cb.see(Turn::promotionQueen(Piece(White, Pawn), A7, A8)));
+    }
+    {
+        // Quiet move onto a field attacked by a pawn
+        ChessBoard cb = ChessBoard::fromFEN("4k3/8/8/3p4/8/8/8/2Q1K3 w - - 0 1");
+        const Turn turn = Turn::move(Piece(White, Queen), C1, C4);
+        EXPECT_EQ(-900, cb.see(turn));
+        EXPECT_TRUE(cb.seeGE(turn, -900));
+        EXPECT_FALSE(cb.seeGE(turn, -899));
+        EXPECT_TRUE(cb.seeGE(Turn::move(Piece(White, Queen), C1, C2), 0));
+    }
+}
+
+TEST(ChessBoard, StaticExchangeEvaluationThreshold) {
+    mt19937 rng(9146);
+
+    for (int game = 0; game < 20; ++game) {
+        GameState gs;
+
+        for (int i = 0; i < 100 && !gs.isGameOver(); ++i) {
+            const ChessBoard& cb = gs.getChessBoard();
+            const std::vector<Turn> turns = gs.getTurnList();
+
+            for (const Turn& turn : turns) {
+                const Score see = cb.see(turn);
+                ASSERT_TRUE(cb.seeGE(turn, see)) << turn << " " << see << cb;
+                ASSERT_FALSE(cb.seeGE(turn, see + 1)) << turn << " " << see << cb;
+            }
+
+            gs.applyTurn(*random_selection(turns, rng));
+        }
+    }
+}
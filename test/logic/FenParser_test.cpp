@@ -0,0 +1,93 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <gtest/gtest.h>
+#include <cstring>
+#include "logic/FenParser.h"
+#include "logic/ChessBoard.h"
+#include "logic/Perft.h"
+
+namespace {
+
+bool parse(const std::string& line, PackedPosition& positionOut) {
+    return FenParser::parse(line.data(), line.data() + line.size(), positionOut);
+}
+
+} // namespace
+
+TEST(FenParser, matchesChessBoard) {
+    for (const Perft::Position& position: Perft::suite()) {
+        PackedPosition parsed;
+        ASSERT_TRUE(parse(position.fen, parsed)) << position.fen;
+        EXPECT_EQ(ChessBoard::fromFEN(position.fen).toPackedPosition(), parsed) << position.fen;
+    }
+
+    const std::string enPassant = "rnbqkbnr/pp1ppppp/8/2p5/4P3/8/PPPP1PPP/RNBQKBNR w KQkq c6 0 2";
+    PackedPosition parsed;
+    ASSERT_TRUE(parse(enPassant, parsed));
+    EXPECT_EQ(C6, parsed.enPassantSquare);
+    EXPECT_EQ(ChessBoard::fromFEN(enPassant).toPackedPosition(), parsed);
+}
+
+TEST(FenParser, epd) {
+    const std::string fen = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 7 23";
+
+    PackedPosition parsed;
+    ASSERT_TRUE(parse("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - "
+                      "bm Qxf6; id \"kiwi;pete\"; hmvc 7; fmvn 23;", parsed));
+    EXPECT_EQ(ChessBoard::fromFEN(fen).toPackedPosition(), parsed);
+
+    // Clocks default to the start of a game
+    ASSERT_TRUE(parse("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -", parsed));
+    EXPECT_EQ(0, parsed.halfMoveClock);
+    EXPECT_EQ(1, parsed.fullMoveClock);
+}
+
+TEST(FenParser, malformed) {
+    const std::vector<std::string> lines = {
+        "",
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP w KQkq - 0 1",           // Missing rank
+        "rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",  // Too many files
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNRR w KQkq - 0 1", // Too many files
+        "rnbqkbnr/ppppxppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",  // Unknown piece
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR x KQkq - 0 1",  // Unknown player
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQxq - 0 1",  // Unknown castling right
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e4 0 1", // Impossible en passant
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1 2",
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 99999 1",
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w"
+    };
+
+    PackedPosition parsed;
+    for (const std::string& line: lines) {
+        EXPECT_FALSE(parse(line, parsed)) << line;
+    }
+}
@@ -35,6 +35,7 @@
 
 #include "logic/GameState.h"
 #include "logic/IncrementalMaterialAndPSTEvaluator.h"
+#include "misc/helper.h"
 
 using namespace std;
 
@@ -60,7 +61,7 @@ TEST(GameState, equality) {
 
 /* Gameover Detection */
 TEST(GameState, gameOverDetection_FiftyMoveRule) {
-    GameState gs(ChessBoard::fromFEN("8/k7/8/8/8/8/K7/8 b - - 99 90"));
+    GameState gs(ChessBoard::fromFEN("8/k7/8/8/8/8/K6R/8 b - - 99 90"));
     ASSERT_FALSE(gs.isGameOver());
     ASSERT_FALSE(gs.isDrawDueTo50MovesRule());
 
@@ -88,6 +89,40 @@ TEST(GameState, gameOverDetection_Stalemate) {
     EXPECT_TRUE(gs.isGameOver());
     EXPECT_EQ(gs.getWinner(), NoPlayer);
 }
+TEST(GameState, gameOverDetection_InsufficientMaterial) {
+    const std::vector<std::string> dead = {
+        "8/k7/8/8/8/8/K7/8 w - - 0 1",
+        "8/k7/8/8/8/8/K7/5B2 b - - 0 1",
+        "8/k7/8/3n4/8/8/K7/8 w - - 0 1",
+        "8/k2b4/8/8/8/8/K7/5B2 w - - 0 1" // Both bishops on light fields
+    };
+    for (const std::string& fen : dead) {
+        GameState gs(ChessBoard::fromFEN(fen));
+        EXPECT_TRUE(gs.isDrawDueToInsufficientMaterial()) << fen;
+        EXPECT_TRUE(gs.isGameOver()) << fen;
+        EXPECT_EQ(NoPlayer, gs.getWinner()) << fen;
+        EXPECT_EQ(0, gs.getScore()) << fen;
+    }
+
+    const std::vector<std::string> alive = {
+        "8/k7/8/8/8/8/K6P/8 w - - 0 1",
+        "8/k7/8/8/8/8/K7/4BB2 w - - 0 1",
+        "8/k7/8/8/8/8/K7/4NN2 w - - 0 1",
+        "8/k7/8/8/8/8/K7/4NB2 b - - 0 1",
+        "8/k1b5/8/8/8/8/K7/5B2 w - - 0 1" // Bishops on differently colored fields
+    };
+    for (const std::string& fen : alive) {
+        GameState gs(ChessBoard::fromFEN(fen));
+        EXPECT_FALSE(gs.isDrawDueToInsufficientMaterial()) << fen;
+        EXPECT_FALSE(gs.isGameOver()) << fen;
+    }
+
+    // Capturing the last pawn ends the game
+    GameState gs(ChessBoard::fromFEN("8/k7/8/8/8/8/Kp6/8 w - - 0 1"));
+    gs.applyTurn(Turn::move(Piece(White, King), A2, B2));
+    EXPECT_TRUE(gs.isGameOver()) << gs;
+    EXPECT_EQ(NoPlayer, gs.getWinner()) << gs;
+}
 
 /* Set Flags correctly on GameState init */
 TEST(GameState, setFlagsOnGameStateLoad_KingInCheck_1) {
@@ -172,3 +207,259 @@ TEST(GameState, setFlagsOnGameStateLoad_Stalemate) {
     EXPECT_TRUE(gs.getChessBoard().isGameOver());
     EXPECT_EQ(gs.getChessBoard().getWinner(), NoPlayer);
 }
+
+//! Expects everything observable of the two game states to match.
+static void expectSameState(const GameState& expected, const GameState& actual) {
+    const ChessBoard& e = expected.getChessBoard();
+    const ChessBoard& a = actual.getChessBoard();
+
+    ASSERT_EQ(e, a) << e << a;
+    ASSERT_EQ(e.toFEN(), a.toFEN());
+    ASSERT_EQ(e.getKingInCheck(), a.getKingInCheck());
+    ASSERT_EQ(e.getCheckmate(), a.getCheckmate());
+    ASSERT_EQ(e.isStalemate(), a.isStalemate());
+    ASSERT_EQ(e.getLastCapturedPiece(), a.getLastCapturedPiece());
+    for (Field field = A1; field <= H8; field = nextField(field)) {
+        ASSERT_EQ(e.getAttacksFrom(field), a.getAttacksFrom(field)) << field << a;
+    }
+
+    const MoveList& expectedTurns = expected.getMoveList();
+    const MoveList& actualTurns = actual.getMoveList();
+    ASSERT_EQ(expectedTurns.size(), actualTurns.size()) << a;
+    for (size_t i = 0; i < expectedTurns.size(); ++i) {
+        ASSERT_EQ(expectedTurns[i], actualTurns[i]) << a;
+    }
+}
+
+TEST(GameState, makeUnmakeTurn) {
+    // Castling, en passant, promotions and captures of castling rooks
+    const std::vector<std::string> fens = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"
+    };
+
+    for (const std::string& fen: fens) {
+        GameState gs = GameState::fromFEN(fen);
+        const GameState initial(gs);
+
+        for (const Turn& turn: initial.getTurnList()) {
+            GameState applied(initial);
+            applied.applyTurn(turn);
+
+            gs.makeTurn(turn);
+            expectSameState(applied, gs);
+
+            for (const Turn& reply: applied.getTurnList()) {
+                GameState appliedReply(applied);
+                appliedReply.applyTurn(reply);
+
+                gs.makeTurn(reply);
+                expectSameState(appliedReply, gs);
+                gs.unmakeTurn();
+                expectSameState(applied, gs);
+            }
+
+            gs.unmakeTurn();
+            expectSameState(initial, gs);
+        }
+    }
+}
+
+TEST(GameState, makeUnmakeNullMove) {
+    const std::vector<std::string> fens = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 3", // En passant
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 b - - 0 1"
+    };
+
+    for (const std::string& fen: fens) {
+        GameState gs = GameState::fromFEN(fen);
+        const GameState initial(gs);
+        const Turn pass = Turn::pass(gs.getNextPlayer());
+
+        // A null move is a cheap pass
+        GameState applied(initial);
+        applied.applyTurn(pass);
+
+        gs.makeTurn(pass);
+        expectSameState(applied, gs);
+        EXPECT_EQ(ERR, gs.getChessBoard().getEnPassantSquare());
+        EXPECT_EQ(initial.getChessBoard().getHalfMoveClock() + 1,
+                  gs.getChessBoard().getHalfMoveClock());
+        EXPECT_EQ(applied.getTurnList().size(), gs.getTurnList().size()) << gs;
+
+        for (const Turn& reply: applied.getTurnList()) {
+            GameState appliedReply(applied);
+            appliedReply.applyTurn(reply);
+
+            gs.makeTurn(reply);
+            expectSameState(appliedReply, gs);
+            gs.unmakeTurn();
+        }
+
+        gs.unmakeTurn();
+        expectSameState(initial, gs);
+    }
+
+    // Passing leads to the same hash as the position with the other side to move
+    GameState gs = GameState::fromFEN(fens[1]);
+    gs.makeTurn(Turn::pass(White));
+    EXPECT_EQ(GameState::fromFEN("rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR b KQkq - 1 3").getHash(),
+              gs.getHash());
+}
+
+TEST(GameState, makeUnmakeRandomGames) {
+    mt19937 rng(4711);
+
+    for (int game = 0; game < 20; ++game) {
+        GameState gs;
+        std::vector<GameState> history;
+
+        for (int i = 0; i < 100 && !gs.isGameOver(); ++i) {
+            history.push_back(gs);
+            gs.makeTurn(*random_selection(gs.getTurnList(), rng));
+        }
+
+        while (!history.empty()) {
+            gs.unmakeTurn();
+            expectSameState(history.back(), gs);
+            history.pop_back();
+        }
+    }
+}
+
+TEST(GameState, copyAfterMakeTurn) {
+    GameState gs;
+    gs.makeTurn(Turn::move(Piece(White, Pawn), E2, E4));
+    gs.makeTurn(Turn::move(Piece(Black, Pawn), E7, E5));
+
+    GameState applied;
+    applied.applyTurn(Turn::move(Piece(White, Pawn), E2, E4));
+    applied.applyTurn(Turn::move(Piece(Black, Pawn), E7, E5));
+
+    // Copies only take the current position along
+    GameState copy(gs);
+    expectSameState(applied, copy);
+
+    GameState assigned;
+    assigned = gs;
+    expectSameState(applied, assigned);
+
+    copy.makeTurn(Turn::move(Piece(White, Knight), G1, F3));
+    copy.unmakeTurn();
+    expectSameState(applied, copy);
+
+    gs.unmakeTurn();
+    gs.unmakeTurn();
+    expectSameState(GameState(), gs);
+}
+
+TEST(GameState, packedPosition) {
+    const GameState gs = GameState::fromFEN(
+                "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    expectSameState(gs, GameState::fromPackedPosition(gs.toPackedPosition()));
+}
+
+TEST(GameState, repetition) {
+    const std::vector<Turn> cycle = {
+        Turn::move(Piece(White, Knight), G1, F3),
+        Turn::move(Piece(Black, Knight), G8, F6),
+        Turn::move(Piece(White, Knight), F3, G1),
+        Turn::move(Piece(Black, Knight), F6, G8)
+    };
+
+    GameState gs;
+    for (const Turn& turn: cycle) {
+        EXPECT_FALSE(gs.isRepetition());
+        gs.applyTurn(turn);
+    }
+    EXPECT_TRUE(gs.isRepetition());
+
+    // The history is part of copies and follows make/unmake
+    GameState copy(gs);
+    EXPECT_TRUE(copy.isRepetition());
+    copy.makeTurn(Turn::move(Piece(White, Pawn), E2, E4));
+    EXPECT_FALSE(copy.isRepetition());
+    copy.unmakeTurn();
+    EXPECT_TRUE(copy.isRepetition());
+
+    for (const Turn& turn: cycle) {
+        copy.makeTurn(turn);
+    }
+    EXPECT_TRUE(copy.isRepetition());
+
+    // Positions before a pawn move can't repeat, the one after it can
+    gs.applyTurn(Turn::move(Piece(White, Pawn), E2, E4));
+    EXPECT_FALSE(gs.isRepetition());
+    gs.applyTurn(Turn::move(Piece(Black, Knight), G8, F6));
+    gs.applyTurn(Turn::move(Piece(White, Knight), G1, F3));
+    gs.applyTurn(Turn::move(Piece(Black, Knight), F6, G8));
+    EXPECT_FALSE(gs.isRepetition());
+    gs.applyTurn(Turn::move(Piece(White, Knight), F3, G1));
+    EXPECT_TRUE(gs.isRepetition());
+
+    // Positions are never repeated across null moves
+    GameState nullMoves;
+    nullMoves.makeTurn(Turn::pass(White));
+    nullMoves.makeTurn(Turn::move(Piece(Black, Knight), G8, F6));
+    nullMoves.makeTurn(Turn::pass(White));
+    nullMoves.makeTurn(Turn::move(Piece(Black, Knight), F6, G8));
+    EXPECT_EQ(GameState().getHash(), nullMoves.getHash());
+    EXPECT_FALSE(nullMoves.isRepetition());
+    nullMoves.unmakeTurn();
+    nullMoves.unmakeTurn();
+    nullMoves.unmakeTurn();
+    nullMoves.unmakeTurn();
+
+    // After taking back the null moves the history is complete again
+    for (const Turn& turn: cycle) {
+        nullMoves.makeTurn(turn);
+    }
+    EXPECT_TRUE(nullMoves.isRepetition());
+}
+
+TEST(GameState, lazyTurnGeneration) {
+    // Fool's mate replayed without looking at the positions in between
+    const std::vector<Turn> turns = {
+        Turn::move(Piece(White, Pawn), F2, F3),
+        Turn::move(Piece(Black, Pawn), E7, E5),
+        Turn::move(Piece(White, Pawn), G2, G4),
+        Turn::move(Piece(Black, Queen), D8, H4)
+    };
+
+    GameState gs;
+    for (const Turn& turn: turns) {
+        gs.applyTurn(turn);
+    }
+    EXPECT_TRUE(gs.isGameOver()) << gs;
+    EXPECT_EQ(Black, gs.getWinner());
+    EXPECT_TRUE(gs.getTurnList().empty());
+    EXPECT_TRUE(gs.getChessBoard().getKingInCheck()[White]);
+
+    // Turn lists generated late have to match eagerly generated ones
+    mt19937 rng(5123);
+    for (int game = 0; game < 20; ++game) {
+        GameState lazy;
+        GameState eager;
+
+        for (int i = 0; i < 100 && !eager.isGameOver(); ++i) {
+            const std::vector<Turn> eagerTurns = eager.getTurnList();
+            const Turn turn = *random_selection(eagerTurns, rng);
+            eager.applyTurn(turn);
+            eager.getTurnList();
+
+            // Only look at every third position of the lazy state
+            lazy.applyTurn(turn);
+            if (i % 3 != 0) continue;
+
+            ASSERT_EQ(eager.getTurnList(), lazy.getTurnList()) << lazy;
+            ASSERT_EQ(eager.isGameOver(), lazy.isGameOver()) << lazy;
+            ASSERT_EQ(eager.getChessBoard().getKingInCheck(),
+                      lazy.getChessBoard().getKingInCheck()) << lazy;
+            ASSERT_EQ(eager.getScore(), lazy.getScore()) << lazy;
+        }
+    }
+}
@@ -0,0 +1,81 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <gtest/gtest.h>
+#include <random>
+#include "logic/MagicBitBoards.h"
+#include "logic/ChessBoard.h"
+
+using namespace std;
+
+TEST(MagicBitBoards, rookMask) {
+    EXPECT_EQ(generateBitBoard(B1, C1, D1, E1, F1, G1,
+                               A2, A3, A4, A5, A6, A7, ERR),
+              MagicBitBoards::rookMask(A1));
+    EXPECT_EQ(generateBitBoard(B4, C4, E4, F4, G4,
+                               D2, D3, D5, D6, D7, ERR),
+              MagicBitBoards::rookMask(D4));
+}
+
+TEST(MagicBitBoards, bishopMask) {
+    EXPECT_EQ(generateBitBoard(B2, C3, D4, E5, F6, G7, ERR),
+              MagicBitBoards::bishopMask(A1));
+    EXPECT_EQ(generateBitBoard(C3, B2, E5, F6, G7, C5, B6, E3, F2, ERR),
+              MagicBitBoards::bishopMask(D4));
+}
+
+TEST(MagicBitBoards, rookAttacks) {
+    const BitBoard allPieces = generateBitBoard(D4, D6, B4, G4, D2, ERR);
+    EXPECT_EQ(generateBitBoard(C4, B4, E4, F4, G4, D5, D6, D3, D2, ERR),
+              MagicBitBoards::rookAttacks(D4, allPieces));
+}
+
+TEST(MagicBitBoards, bishopAttacks) {
+    const BitBoard allPieces = generateBitBoard(F2, H4, C5, ERR);
+    EXPECT_EQ(generateBitBoard(G3, H4, E3, D4, C5, G1, E1, ERR),
+              MagicBitBoards::bishopAttacks(F2, allPieces));
+}
+
+TEST(MagicBitBoards, lookupMatchesRayWalk) {
+    mt19937_64 rng(1234);
+    for (int i = 0; i < 1000; ++i) {
+        // Sparse random occupancy resembling real positions
+        const BitBoard allPieces = rng() & rng();
+        for (Field field = A1; field <= H8; field = nextField(field)) {
+            ASSERT_EQ(MagicBitBoards::slowRookAttacks(field, allPieces),
+                      MagicBitBoards::rookAttacks(field, allPieces))
+                    << field << bitBoardToString(allPieces);
+            ASSERT_EQ(MagicBitBoards::slowBishopAttacks(field, allPieces),
+                      MagicBitBoards::bishopAttacks(field, allPieces))
+                    << field << bitBoardToString(allPieces);
+        }
+    }
+}
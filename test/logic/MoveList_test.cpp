@@ -0,0 +1,73 @@
+/*
+    Copyright (c) 2013-2014, Stefan Hacker <dd0t@users.sourceforge.net>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <gtest/gtest.h>
+#include "logic/MoveList.h"
+
+TEST(MoveList, pushAndIterate) {
+    MoveList list;
+    EXPECT_TRUE(list.empty());
+
+    list.push_back(Move(E2, E4));
+    list.push_back(Move(G1, F3));
+
+    ASSERT_EQ(2U, list.size());
+    EXPECT_EQ(Move(E2, E4), list[0]);
+    EXPECT_EQ(Move(G1, F3), list[1]);
+
+    size_t count = 0;
+    for (const Move& move: list) {
+        EXPECT_EQ(list[count], move);
+        ++count;
+    }
+    EXPECT_EQ(list.size(), count);
+
+    list.clear();
+    EXPECT_TRUE(list.empty());
+    EXPECT_EQ(list.begin(), list.end());
+}
+
+TEST(MoveList, copy) {
+    MoveList list;
+    for (size_t i = 0; i < MoveList::CAPACITY; ++i) {
+        list.push_back(Move(A1, static_cast<Field>(i % NUM_FIELDS)));
+    }
+
+    MoveList copy(list);
+    ASSERT_EQ(list.size(), copy.size());
+    EXPECT_TRUE(std::equal(list.begin(), list.end(), copy.begin()));
+
+    MoveList other;
+    other.push_back(Move(E8, E7));
+    copy = other;
+    ASSERT_EQ(1U, copy.size());
+    EXPECT_EQ(other[0], copy[0]);
+}
@@ -0,0 +1,83 @@
+/*
+    Copyright (c) 2013-2014, Stefan Hacker <dd0t@users.sourceforge.net>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <gtest/gtest.h>
+#include "logic/Move.h"
+#include "logic/GameState.h"
+
+TEST(Move, pack) {
+    EXPECT_EQ(2U, sizeof(Move));
+    EXPECT_TRUE(Move().isNull());
+
+    const Move move(Turn::promotionKnight(Piece(Black, Pawn), B2, A1));
+    EXPECT_FALSE(move.isNull());
+    EXPECT_EQ(B2, move.getFrom());
+    EXPECT_EQ(A1, move.getTo());
+    EXPECT_EQ(Turn::PromotionKnight, move.getAction());
+    EXPECT_EQ(Turn::promotionKnight(Piece(Black, Pawn), B2, A1),
+              move.toTurn(Piece(Black, Pawn)));
+}
+
+TEST(Move, roundTripGeneratedTurns) {
+    // Castling, promotions and en passant
+    const std::vector<std::string> fens = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 b kq - 0 1",
+        "8/8/8/3pP3/8/8/8/K6k w - d6 0 1"
+    };
+
+    for (const std::string& fen: fens) {
+        GameState gs = GameState::fromFEN(fen);
+        const std::vector<Turn> turns = gs.getTurnList();
+        for (const Turn& turn: turns) {
+            const Move move(turn);
+            EXPECT_TRUE(move.matches(turn));
+            EXPECT_EQ(turn, move.toTurn(gs.getChessBoard())) << fen;
+            EXPECT_EQ(&turn, findTurn(turns, move));
+            EXPECT_NE(nullptr, findTurn(gs.getMoveList(), move));
+        }
+    }
+}
+
+TEST(Move, findTurn) {
+    GameState gs;
+    const std::vector<Turn> turns = gs.getTurnList();
+    EXPECT_EQ(nullptr, findTurn(turns, Move()));
+    EXPECT_EQ(nullptr, findTurn(turns, Move(E2, E5)));
+
+    const Turn* turn = findTurn(turns, Move(G1, F3));
+    ASSERT_NE(nullptr, turn);
+    EXPECT_EQ(Turn::move(Piece(White, Knight), G1, F3), *turn);
+
+    const Move* move = findTurn(gs.getMoveList(), Move(G1, F3));
+    ASSERT_NE(nullptr, move);
+    EXPECT_EQ(Move(G1, F3), *move);
+}
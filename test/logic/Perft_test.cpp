@@ -0,0 +1,104 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <gtest/gtest.h>
+#include "logic/Perft.h"
+
+TEST(Perft, suite) {
+    // Keep the unit test quick, the perft tool runs the deep counts
+    const uint64_t MAX_NODES = 100000;
+
+    for (const Perft::Position& position: Perft::suite()) {
+        const GameState state = GameState::fromFEN(position.fen);
+
+        for (size_t depth = 1; depth <= position.nodes.size(); ++depth) {
+            if (position.nodes[depth - 1] > MAX_NODES) break;
+
+            EXPECT_EQ(position.nodes[depth - 1], Perft::perft(state, depth))
+                    << position.name << " depth " << depth;
+        }
+    }
+}
+
+TEST(Perft, divide) {
+    const GameState state;
+    const auto entries = Perft::divide(state, 3);
+
+    ASSERT_EQ(20U, entries.size());
+
+    uint64_t nodes = 0;
+    for (const Perft::DivideEntry& entry: entries) {
+        nodes += entry.nodes;
+        if (entry.turn == Turn::move(Piece(White, Pawn), E2, E4)) {
+            EXPECT_EQ("e2e4", Perft::toCoordinateNotation(entry.turn));
+            EXPECT_EQ(600U, entry.nodes);
+        }
+    }
+    EXPECT_EQ(8902U, nodes);
+}
+
+TEST(Perft, coordinateNotation) {
+    EXPECT_EQ("b2a1n", Perft::toCoordinateNotation(Turn::promotionKnight(Piece(Black, Pawn), B2, A1)));
+    EXPECT_EQ("e1g1", Perft::toCoordinateNotation(Turn::castle(Piece(White, King), E1, G1)));
+}
+
+TEST(Perft, hashTable) {
+    PerftHashTable table(1000);
+    EXPECT_EQ(512U, table.getTableSize());
+
+    uint64_t nodes = 0;
+    EXPECT_FALSE(table.lookup(0x1234, 3, nodes));
+
+    table.store(0x1234, 3, 97862);
+    EXPECT_TRUE(table.lookup(0x1234, 3, nodes));
+    EXPECT_EQ(97862U, nodes);
+
+    EXPECT_FALSE(table.lookup(0x1234, 4, nodes));
+    EXPECT_FALSE(table.lookup(0x1234 + 512, 3, nodes));
+
+    table.clear();
+    EXPECT_FALSE(table.lookup(0x1234, 3, nodes));
+}
+
+TEST(Perft, parallelWithHashTable) {
+    PerftHashTable table(1 << 16);
+
+    for (const Perft::Position& position: Perft::suite()) {
+        const GameState state = GameState::fromFEN(position.fen);
+        const int depth = position.nodes.size() >= 4 && position.nodes[3] < 500000 ? 4 : 3;
+
+        EXPECT_EQ(position.nodes[depth - 1], Perft::parallelPerft(state, depth, 4, &table))
+                << position.name << " depth " << depth;
+        // Second run is mostly answered from the table
+        EXPECT_EQ(position.nodes[depth - 1], Perft::parallelPerft(state, depth, 4, &table))
+                << position.name << " depth " << depth;
+    }
+}
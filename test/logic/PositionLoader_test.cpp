@@ -0,0 +1,99 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <boost/filesystem.hpp>
+#include "logic/PositionLoader.h"
+#include "logic/ChessBoard.h"
+#include "logic/Perft.h"
+
+namespace {
+
+//! Suite positions as FEN, EPD, with comments, blank and CRLF lines.
+std::string generateInput(std::vector<PackedPosition>& expectedOut) {
+    std::stringstream ss;
+    ss << "# Perft suite" << std::endl;
+    for (int i = 0; i < 50; ++i) {
+        for (const Perft::Position& position: Perft::suite()) {
+            const ChessBoard cb = ChessBoard::fromFEN(position.fen);
+            expectedOut.push_back(cb.toPackedPosition());
+
+            ss << position.fen << ((i % 2) ? "\r\n" : "\n");
+            if (i % 7 == 0) ss << std::endl;
+        }
+    }
+    ss << "not a position";
+    return ss.str();
+}
+
+} // namespace
+
+TEST(PositionLoader, loadBuffer) {
+    std::vector<PackedPosition> expected;
+    const std::string input = generateInput(expected);
+
+    for (unsigned int threads: { 1, 2, 3, 8 }) {
+        const PositionLoader::Result result = PositionLoader::loadBuffer(
+                    input.data(), input.data() + input.size(), threads);
+
+        EXPECT_EQ(expected.size() + 1, result.lines) << threads;
+        EXPECT_EQ(1, result.errors) << threads;
+        EXPECT_EQ(input.size(), result.bytes);
+        // Order has to be kept no matter how the input was split
+        EXPECT_TRUE(expected == result.positions) << threads;
+    }
+}
+
+TEST(PositionLoader, loadFile) {
+    std::vector<PackedPosition> expected;
+    const std::string input = generateInput(expected);
+
+    const boost::filesystem::path path = boost::filesystem::temp_directory_path()
+            / boost::filesystem::unique_path();
+    {
+        std::ofstream file(path.string(), std::ios::binary);
+        file << input;
+    }
+
+    const PositionLoader::Result result = PositionLoader::loadFile(path.string(), 4);
+    EXPECT_TRUE(expected == result.positions);
+    EXPECT_EQ(1, result.errors);
+
+    // Empty files can't be mapped but are fine nonetheless
+    {
+        std::ofstream file(path.string(), std::ios::binary | std::ios::trunc);
+    }
+    EXPECT_TRUE(PositionLoader::loadFile(path.string(), 4).positions.empty());
+
+    boost::filesystem::remove(path);
+}
@@ -30,6 +30,7 @@
     POSSIBILITY OF SUCH DAMAGE.
 */
 #include <gtest/gtest.h>
+#include <algorithm>
 #include "logic/GameState.h"
 
 /* TESTING the generated turns */
@@ -679,6 +680,143 @@ TEST(TurnGeneratorExtern, generateTurns_bugReport_33) {
             << gs << turnVecToString(turns_calc);
 }
 
+/* Testing pinned pieces, en passant legality and double check */
+TEST(TurnGeneratorExtern, generateTurns_pinnedPiece) {
+    // The bishop on E2 is pinned by the rook on E8 and cannot move at all,
+    // the rook on D2 pinned by the bishop on A5 neither.
+    GameState gs(ChessBoard::fromFEN("4r1k1/8/8/b7/8/8/3RB3/4K3 w - - 0 1"));
+    turns_calc = gs.getTurnList();
+
+    EXPECT_FALSE(turnVecContains(turns_calc, Turn::move(Piece(White, Bishop), E2, D3)))
+            << gs << turnVecToString(turns_calc);
+    EXPECT_FALSE(turnVecContains(turns_calc, Turn::move(Piece(White, Rook), D2, D8)))
+            << gs << turnVecToString(turns_calc);
+    EXPECT_FALSE(turnVecContains(turns_calc, Turn::move(Piece(White, Rook), D2, C3)))
+            << gs << turnVecToString(turns_calc);
+
+    // A pinned slider may still move along the pin ray.
+    GameState gs2(ChessBoard::fromFEN("4r1k1/8/8/8/8/8/4R3/4K3 w - - 0 1"));
+    turns_calc = gs2.getTurnList();
+
+    EXPECT_TRUE(turnVecContains(turns_calc, Turn::move(Piece(White, Rook), E2, E8)))
+            << gs2 << turnVecToString(turns_calc);
+    EXPECT_TRUE(turnVecContains(turns_calc, Turn::move(Piece(White, Rook), E2, E5)))
+            << gs2 << turnVecToString(turns_calc);
+    EXPECT_FALSE(turnVecContains(turns_calc, Turn::move(Piece(White, Rook), E2, D2)))
+            << gs2 << turnVecToString(turns_calc);
+}
+TEST(TurnGeneratorExtern, generateTurns_enPassantDiscoveredCheck) {
+    // Capturing en passant would remove both pawns from the fifth rank and
+    // expose the king to the rook.
+    GameState gs(ChessBoard::fromFEN("8/8/8/K2pP2r/8/8/8/7k w - d6 0 1"));
+    turns_calc = gs.getTurnList();
+
+    EXPECT_FALSE(turnVecContains(turns_calc, Turn::move(Piece(White, Pawn), E5, D6)))
+            << gs << turnVecToString(turns_calc);
+    EXPECT_TRUE(turnVecContains(turns_calc, Turn::move(Piece(White, Pawn), E5, E6)))
+            << gs << turnVecToString(turns_calc);
+}
+TEST(TurnGeneratorExtern, generateTurns_enPassantEvasion) {
+    // The pawn on D5 gives check and can be captured en passant.
+    GameState gs(ChessBoard::fromFEN("8/8/8/3pP3/4K3/8/8/7k w - d6 0 1"));
+    turns_calc = gs.getTurnList();
+
+    EXPECT_TRUE(turnVecContains(turns_calc, Turn::move(Piece(White, Pawn), E5, D6)))
+            << gs << turnVecToString(turns_calc);
+    EXPECT_FALSE(turnVecContains(turns_calc, Turn::move(Piece(White, Pawn), E5, E6)))
+            << gs << turnVecToString(turns_calc);
+}
+TEST(TurnGeneratorExtern, generateTurns_doubleCheck) {
+    // Rook and knight give check. Only king moves are legal, capturing
+    // the knight with the rook is not.
+    GameState gs(ChessBoard::fromFEN("4k3/8/r2N4/8/8/8/8/4R1K1 b - - 0 1"));
+    turns_calc = gs.getTurnList();
+
+    for (const Turn& turn: turns_calc) {
+        EXPECT_EQ(King, turn.piece.type) << gs << turnVecToString(turns_calc);
+    }
+    EXPECT_FALSE(turns_calc.empty()) << gs;
+}
+
+TEST(TurnGeneratorExtern, generateTurns_evasionKingAlongCheckRay) {
+    // The king may not step back on the rook's ray
+    GameState gs(ChessBoard::fromFEN("4k3/8/8/8/8/8/8/K3R3 b - - 0 1"));
+    turns_calc = gs.getTurnList();
+
+    turns_fine.clear();
+    turns_fine.push_back(Turn::move(Piece(Black, King), E8, D8));
+    turns_fine.push_back(Turn::move(Piece(Black, King), E8, F8));
+    turns_fine.push_back(Turn::move(Piece(Black, King), E8, D7));
+    turns_fine.push_back(Turn::move(Piece(Black, King), E8, F7));
+
+    EXPECT_TRUE(turnVecCompare(turns_calc, turns_fine))
+            << gs << turnVecToString(turns_calc);
+}
+
+TEST(TurnGeneratorExtern, generateTurns_evasionSingleCheck) {
+    // Capture the checking bishop, interpose or move the king
+    GameState gs(ChessBoard::fromFEN("4k3/8/8/8/Rb6/8/8/1N2K3 w - - 0 1"));
+    turns_calc = gs.getTurnList();
+
+    turns_fine.clear();
+    turns_fine.push_back(Turn::move(Piece(White, King), E1, D1));
+    turns_fine.push_back(Turn::move(Piece(White, King), E1, E2));
+    turns_fine.push_back(Turn::move(Piece(White, King), E1, F1));
+    turns_fine.push_back(Turn::move(Piece(White, King), E1, F2));
+    turns_fine.push_back(Turn::move(Piece(White, Knight), B1, C3));
+    turns_fine.push_back(Turn::move(Piece(White, Knight), B1, D2));
+    turns_fine.push_back(Turn::move(Piece(White, Rook), A4, B4));
+
+    EXPECT_TRUE(turnVecCompare(turns_calc, turns_fine))
+            << gs << turnVecToString(turns_calc);
+    EXPECT_TRUE(gs.getChessBoard().getKingInCheck()[White]);
+}
+
+/* Testing the fast paths against the generated turn lists */
+TEST(TurnGeneratorExtern, hasAnyLegalMoveAndCountLegalMoves) {
+    const std::vector<std::string> fens = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "k7/8/1K6/8/8/8/8/1R6 w - - 0 1",    // Mate in one
+        "7k/5Q2/6K1/8/8/8/8/8 b - - 0 1",    // Stalemate
+        "R6k/6pp/8/8/8/8/8/K7 b - - 0 1"     // Checkmate
+    };
+
+    std::mt19937 rng(2718);
+    for (const std::string& fen : fens) {
+        GameState gs = GameState::fromFEN(fen);
+
+        for (int i = 0; i < 30; ++i) {
+            const ChessBoard& cb = gs.getChessBoard();
+            TurnGenerator turnGen;
+            const bool anyTurn = turnGen.hasAnyLegalMove(cb.getNextPlayer(), cb);
+            const size_t count = turnGen.countLegalMoves(cb.getNextPlayer(), cb);
+
+            const std::vector<Turn> turns = gs.getTurnList();
+            ASSERT_EQ(!turns.empty(), anyTurn) << gs;
+            ASSERT_EQ(turns.size(), count) << gs;
+            ASSERT_EQ(turns.size(), gs.countLegalMoves()) << gs;
+
+            if (turns.empty()) break;
+            gs.applyTurn(*random_selection(turns, rng));
+        }
+    }
+
+    // Flags set without turn list have to match the generated ones
+    GameState stalemate = GameState::fromFEN(fens[6]);
+    EXPECT_FALSE(stalemate.hasAnyLegalMove());
+    EXPECT_TRUE(stalemate.isGameOver());
+    EXPECT_TRUE(stalemate.getChessBoard().isStalemate());
+
+    GameState checkmate = GameState::fromFEN(fens[7]);
+    EXPECT_EQ(0u, checkmate.countLegalMoves());
+    EXPECT_TRUE(checkmate.isGameOver());
+    EXPECT_EQ(White, checkmate.getWinner());
+}
+
 /*
 // Bug-Report #34
 TEST(TurnGeneratorExtern, generateTurns_bugReport_34) {
@@ -698,3 +836,88 @@ TEST(TurnGeneratorExtern, generateTurns_deathPosition) {
     // 3rkbr1/p1Nn1pp1/3p3p/8/8/3PP3/PP3PPP/R1B3KR b - - 94 68 ???
 }
 */
+
+TEST(TurnGeneratorExtern, generateCaptures) {
+    const std::vector<std::string> fens = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "8/8/8/2k5/3Pp3/8/8/4K3 b - d3 0 1"  // En passant
+    };
+
+    std::mt19937 rng(3141);
+    for (const std::string& fen : fens) {
+        GameState gs = GameState::fromFEN(fen);
+
+        for (int i = 0; i < 30; ++i) {
+            const ChessBoard& cb = gs.getChessBoard();
+            const std::vector<Turn> turns = gs.getTurnList();
+
+            // Captures are the turns taking a piece or promoting to a queen
+            MoveList expected;
+            for (const Turn& turn : turns) {
+                const bool capture = cb.getPieceAt(turn.to).type != NoType
+                        || (turn.piece.type == Pawn && turn.to == cb.getEnPassantSquare());
+                if (turn.action == Turn::PromotionQueen || (capture && !turn.isPromotion())) {
+                    expected.push_back(Move(turn));
+                }
+            }
+
+            MoveList captures;
+            gs.generateCaptures(captures);
+            ASSERT_EQ(expected.size(), captures.size()) << gs;
+            for (const Move& move : captures) {
+                EXPECT_NE(expected.end(), std::find(expected.begin(), expected.end(), move))
+                        << move.toString() << " in " << gs;
+            }
+
+            if (turns.empty()) break;
+            gs.applyTurn(*random_selection(turns, rng));
+        }
+    }
+}
+
+TEST(TurnGeneratorExtern, generateQuietsAndIsLegalMove) {
+    const std::vector<std::string> fens = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "8/8/8/2k5/3Pp3/8/8/4K3 b - d3 0 1"  // En passant
+    };
+
+    std::mt19937 rng(1618);
+    for (const std::string& fen : fens) {
+        GameState gs = GameState::fromFEN(fen);
+
+        for (int i = 0; i < 30; ++i) {
+            const MoveList& moves = gs.getMoveList();
+
+            // Captures and quiets together are exactly the legal turns
+            MoveList staged;
+            gs.generateCaptures(staged);
+            gs.generateQuiets(staged);
+            ASSERT_EQ(moves.size(), staged.size()) << gs;
+            for (const Move& move : moves) {
+                EXPECT_NE(staged.end(), std::find(staged.begin(), staged.end(), move))
+                        << move.toString() << " in " << gs;
+            }
+
+            // Every from/to/action combination is legal iff it is generated
+            for (int from = 0; from < NUM_FIELDS; ++from) {
+                for (int to = 0; to < NUM_FIELDS; ++to) {
+                    for (Turn::Action action : { Turn::Move, Turn::Castle,
+                                                 Turn::PromotionQueen, Turn::PromotionKnight }) {
+                        const Move move(static_cast<Field>(from), static_cast<Field>(to), action);
+                        const bool generated = std::find(moves.begin(), moves.end(), move) != moves.end();
+                        ASSERT_EQ(generated, gs.isLegalMove(move)) << move.toString() << " in " << gs;
+                    }
+                }
+            }
+
+            if (moves.empty()) break;
+            gs.applyTurn(random_selection(moves, rng)->toTurn(gs.getChessBoard()));
+        }
+    }
+}
@@ -0,0 +1,66 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <iostream>
+#include <thread>
+#include <boost/program_options.hpp>
+
+#include "logic/PositionLoader.h"
+
+using namespace std;
+namespace po = boost::program_options;
+
+/* Loads a file with one FEN or EPD position per line and reports the
+   parse throughput. Returns non-zero if a line couldn't be parsed. */
+
+int main(int argn, char **argv) {
+    po::options_description desc("loadpositions");
+    desc.add_options()
+        ("help", "Print help message")
+        ("file", po::value<string>(), "File with one FEN or EPD position per line")
+        ("threads", po::value<unsigned int>()->default_value(max(1U, thread::hardware_concurrency())), "Number of parser threads")
+        ;
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argn, argv, desc), vm);
+
+    if (vm.count("help") || !vm.count("file")) {
+        cerr << desc << endl;
+        return 1;
+    }
+
+    const PositionLoader::Result result = PositionLoader::loadFile(
+                vm["file"].as<string>(), vm["threads"].as<unsigned int>());
+
+    cout << result.toString() << endl;
+
+    return result.errors ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+/*
+    Copyright (c) 2013-2014, Stefan Hacker <dd0t@users.sourceforge.net>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+#include <boost/program_options.hpp>
+
+#include "logic/MagicBitBoards.h"
+#include "logic/BitOperations.h"
+
+using namespace std;
+namespace po = boost::program_options;
+
+/* Searches fixed shift magics for the sliding pieces and prints them
+   in the format expected by src/logic/MagicBitBoards.cpp */
+
+namespace {
+
+BitBoard findMagic(Field field,
+                   BitBoard (*mask)(Field),
+                   BitBoard (*slowAttacks)(Field, BitBoard),
+                   mt19937_64& rng) {
+    const BitBoard fieldMask = mask(field);
+    const int bits = BitOperations::popCount(fieldMask);
+    const int shift = 64 - bits;
+
+    vector<BitBoard> occupancies;
+    vector<BitBoard> attacks;
+    BitBoard subset = 0;
+    do {
+        occupancies.push_back(subset);
+        attacks.push_back(slowAttacks(field, subset));
+        subset = (subset - fieldMask) & fieldMask;
+    } while (subset != 0);
+
+    vector<BitBoard> used(size_t(1) << bits);
+    vector<bool> taken(size_t(1) << bits);
+
+    for (;;) {
+        // Sparse candidates tend to make good magics
+        const BitBoard magic = rng() & rng() & rng();
+        if (BitOperations::popCount((fieldMask * magic) & 0xFF00000000000000ULL) < 6) continue;
+
+        fill(begin(taken), end(taken), false);
+        bool fail = false;
+        for (size_t i = 0; i < occupancies.size() && !fail; ++i) {
+            const size_t index = static_cast<size_t>((occupancies[i] * magic) >> shift);
+            if (!taken[index]) {
+                taken[index] = true;
+                used[index] = attacks[i];
+            } else if (used[index] != attacks[i]) {
+                fail = true;
+            }
+        }
+
+        if (!fail) return magic;
+    }
+}
+
+void printMagics(BitBoard (*mask)(Field),
+                 BitBoard (*slowAttacks)(Field, BitBoard),
+                 mt19937_64& rng) {
+    for (Field field = A1; field <= H8; field = nextField(field)) {
+        if (field % 4 == 0) cout << "   ";
+        cout << " 0x" << hex << uppercase << setw(16) << setfill('0')
+             << findMagic(field, mask, slowAttacks, rng) << "ULL,";
+        if (field % 4 == 3) cout << endl;
+    }
+    cout << dec;
+}
+
+} // namespace
+
+int main(int argn, char **argv) {
+    po::options_description desc("magicgen");
+    desc.add_options()
+        ("help", "Print help message")
+        ("seed", po::value<unsigned int>()->default_value(5253), "Seed for the magic candidate generator")
+        ;
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argn, argv, desc), vm);
+
+    if (vm.count("help")) {
+        cerr << desc << endl;
+        return 1;
+    }
+
+    mt19937_64 rng(vm["seed"].as<unsigned int>());
+
+    cout << "// ROOK_MAGICS" << endl;
+    printMagics(&MagicBitBoards::rookMask, &MagicBitBoards::slowRookAttacks, rng);
+    cout << "// BISHOP_MAGICS" << endl;
+    printMagics(&MagicBitBoards::bishopMask, &MagicBitBoards::slowBishopAttacks, rng);
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+/*
+    Copyright (c) 2013-2014, Max Stark <max.stark88@googlemail.com>
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    3. Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <iostream>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <boost/program_options.hpp>
+
+#include "logic/Perft.h"
+
+using namespace std;
+namespace po = boost::program_options;
+
+/* Counts the leaf nodes of the turn generation either for a single
+   position (optionally divided by root turn) or for the built-in suite
+   of positions with known node counts. Returns non-zero on mismatch. */
+
+namespace {
+
+double nodesPerSecond(uint64_t nodes, chrono::steady_clock::duration duration) {
+    const double seconds = chrono::duration<double>(duration).count();
+    return seconds > 0 ? nodes / seconds : 0;
+}
+
+int runSingle(const string& fen, int depth, bool divide,
+              unsigned int threads, PerftHashTable* table) {
+    const GameState state = GameState::fromFEN(fen);
+    const auto start = chrono::steady_clock::now();
+
+    uint64_t nodes = 0;
+    if (divide && depth > 0) {
+        for (const Perft::DivideEntry& entry: Perft::divide(state, depth, threads, table)) {
+            cout << Perft::toCoordinateNotation(entry.turn) << ": " << entry.nodes << endl;
+            nodes += entry.nodes;
+        }
+        cout << endl;
+    } else {
+        nodes = Perft::parallelPerft(state, depth, threads, table);
+    }
+
+    const auto duration = chrono::steady_clock::now() - start;
+    cout << "Nodes: " << nodes << endl
+         << "Time:  " << chrono::duration_cast<chrono::milliseconds>(duration).count() << " ms" << endl
+         << "NPS:   " << static_cast<uint64_t>(nodesPerSecond(nodes, duration)) << endl;
+
+    return 0;
+}
+
+int runSuite(int maxDepth, unsigned int threads, PerftHashTable* table) {
+    int failures = 0;
+    uint64_t totalNodes = 0;
+    const auto suiteStart = chrono::steady_clock::now();
+
+    for (const Perft::Position& position: Perft::suite()) {
+        const GameState state = GameState::fromFEN(position.fen);
+        const int depths = min(maxDepth, static_cast<int>(position.nodes.size()));
+
+        for (int depth = 1; depth <= depths; ++depth) {
+            const auto start = chrono::steady_clock::now();
+            const uint64_t nodes = Perft::parallelPerft(state, depth, threads, table);
+            const auto duration = chrono::steady_clock::now() - start;
+            const uint64_t expected = position.nodes[depth - 1];
+
+            totalNodes += nodes;
+
+            cout << position.name << " depth " << depth << ": " << nodes
+                 << " (" << static_cast<uint64_t>(nodesPerSecond(nodes, duration)) << " nps)";
+            if (nodes != expected) {
+                cout << " FAILED, expected " << expected;
+                ++failures;
+            }
+            cout << endl;
+        }
+    }
+
+    const auto duration = chrono::steady_clock::now() - suiteStart;
+    cout << endl << "Total nodes: " << totalNodes
+         << " (" << static_cast<uint64_t>(nodesPerSecond(totalNodes, duration)) << " nps)" << endl
+         << (failures ? "FAILED" : "PASSED") << endl;
+
+    return failures ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argn, char **argv) {
+    po::options_description desc("perft");
+    desc.add_options()
+        ("help", "Print help message")
+        ("fen", po::value<string>(), "Position to count, runs the built-in suite if omitted")
+        ("depth", po::value<int>()->default_value(4), "Search depth (maximum depth for the suite)")
+        ("divide", "Print node counts per root turn")
+        ("threads", po::value<unsigned int>()->default_value(max(1U, thread::hardware_concurrency())), "Number of worker threads")
+        ("hash", po::value<unsigned int>()->default_value(64), "Size of the shared perft hash table in MB, 0 to disable")
+        ;
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argn, argv, desc), vm);
+
+    if (vm.count("help")) {
+        cerr << desc << endl;
+        return 1;
+    }
+
+    const int depth = vm["depth"].as<int>();
+    const unsigned int threads = max(1U, vm["threads"].as<unsigned int>());
+    const size_t hashBytes = static_cast<size_t>(vm["hash"].as<unsigned int>()) << 20;
+
+    unique_ptr<PerftHashTable> table;
+    if (hashBytes > 0) {
+        table.reset(new PerftHashTable(hashBytes / (2 * sizeof(uint64_t))));
+    }
+
+    cout << "Threads: " << threads << ", hash entries: "
+         << (table ? table->getTableSize() : 0) << endl << endl;
+
+    if (vm.count("fen")) {
+        return runSingle(vm["fen"].as<string>(), depth, vm.count("divide") > 0,
+                         threads, table.get());
+    }
+
+    return runSuite(depth, threads, table.get());
+}